@@ -5,30 +5,94 @@
 #include <QProcess>
 #include <QMutex>
 #include <QString>
+#include <QStringList>
+#include <QQueue>
+#include <QElapsedTimer>
+#include <memory>
+#include <vector>
 #include "cfg_analyzer.h"
 
+// Runs translation units in a pool of worker processes (this executable
+// started with --analysis-worker). A Clang crash or OOM only takes down one
+// worker: it is restarted and its job requeued, up to a retry limit.
+// Workers are also recycled after a job count or peak RSS threshold, so
+// Clang's global state and heap growth never accumulate in one process.
 class CFGBridge : public QObject {
     Q_OBJECT
 public:
+    struct Options {
+        int workers = 0;                        // 0 = one per hardware thread
+        int maxJobsPerWorker = 64;
+        qint64 maxWorkerMemoryKb = 2 * 1024 * 1024;
+        int maxRetries = 2;
+    };
+
     explicit CFGBridge(QObject* parent = nullptr);
+    CFGBridge(const Options& options, QObject* parent = nullptr);
     ~CFGBridge();
 
     CFGAnalyzer::AnalysisResult analyzeFileSync(const QString& filePath);
     void analyzeFile(const QString& filePath);
 
+    // Batch runs; analysisComplete carries the merged result. buildPath is
+    // a build directory or compile_commands.json; empty uses default flags.
+    void analyzeFiles(const QStringList& filePaths, const QString& buildPath = QString());
+    void analyzeProject(const QString& buildPath);
+
+    bool isBusy() const { return m_batchActive; }
+
+    // Moves out the result last carried by analysisComplete.
+    CFGAnalyzer::AnalysisResult takeResult() { return std::move(m_result); }
+
+    // Entry point of a worker process: reads jobs from stdin, writes results
+    // to stdout until stdin closes.
+    static int runWorker();
+
 signals:
     void analysisComplete(const CFGAnalyzer::AnalysisResult& result);
+    void progress(int completed, int total);
     void errorOccurred(const QString& message);
 
-private slots:
-    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
-    void onProcessError(QProcess::ProcessError error);
-
 private:
-    QProcess* m_process;
+    struct Job {
+        int index = 0;
+        QString filePath;
+        int attempts = 0;
+    };
+
+    struct Worker {
+        QProcess* process = nullptr;
+        int jobIndex = -1;
+        int jobsDone = 0;
+        bool retiring = false;
+        QByteArray buffer;
+    };
+
+    void startBatch(const QStringList& filePaths, const QString& buildPath);
+    void dispatch();
+    Worker* startWorker();
+    void sendJob(Worker* worker, int index);
+    void onWorkerOutput(Worker* worker);
+    void onWorkerFinished(Worker* worker, int exitCode, QProcess::ExitStatus exitStatus);
+    void removeWorker(Worker* worker);
+    void completeJob(int index, CFGAnalyzer::AnalysisResult&& result);
+    void finishBatch();
+
+    Options m_options;
     CFGAnalyzer::CFGAnalyzer m_analyzer;
-    QString m_outputDotFile;
-    QString m_outputReportFile;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    bool m_batchActive = false;
+    QString m_buildPath;
+    std::vector<Job> m_jobs;
+    QQueue<int> m_queue;
+    std::vector<CFGAnalyzer::AnalysisResult> m_partials;
+    CFGAnalyzer::AnalysisResult m_result;
+    int m_completed = 0;
+    int m_retried = 0;
+    int m_crashes = 0;
+    int m_recycles = 0;
+    QElapsedTimer m_timer;
 };
 
-#endif // CFGBRIDGE_H
\ No newline at end of file
+#endif // CFGBRIDGE_H
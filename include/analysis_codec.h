@@ -0,0 +1,20 @@
+#ifndef ANALYSIS_CODEC_H
+#define ANALYSIS_CODEC_H
+
+#include "cfg_analyzer.h"
+#include <QByteArray>
+
+namespace CFGAnalyzer {
+
+    // Compact binary form of an AnalysisResult (QDataStream, versioned),
+    // used to move per-TU results between processes and into binary output.
+    // Callers are expected to regenerate DOT/report text from the decoded
+    // data; both are carried only so that failure reports survive the trip.
+    namespace AnalysisCodec {
+        QByteArray encode(const AnalysisResult& result);
+        bool decode(const QByteArray& data, AnalysisResult& result);
+    }
+
+} // namespace CFGAnalyzer
+
+#endif // ANALYSIS_CODEC_H
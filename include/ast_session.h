@@ -0,0 +1,83 @@
+#ifndef AST_SESSION_H
+#define AST_SESSION_H
+
+#include <clang/Frontend/ASTUnit.h>
+#include <llvm/ADT/IntrusiveRefCntPtr.h>
+#include <llvm/Support/VirtualFileSystem.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CFGAnalyzer {
+
+    class UnsavedBufferFileSystem;
+
+    // Keeps one ASTUnit per file alive for the lifetime of the session. The
+    // first parse precompiles the preamble (the leading #include block) in
+    // memory; later parses of the same file only re-parse the main-file body
+    // as long as the preamble is still valid.
+    class ASTSession {
+    public:
+        struct Timings {
+            double firstParseMs = 0.0;
+            double lastReparseMs = 0.0;
+            unsigned reparseCount = 0;
+        };
+
+        explicit ASTSession(std::vector<std::string> compileArgs = defaultArgs());
+        ~ASTSession();
+
+        ASTSession(const ASTSession&) = delete;
+        ASTSession& operator=(const ASTSession&) = delete;
+
+        static std::vector<std::string> defaultArgs();
+        static std::string resourceDir();
+
+        // Parses (or reparses) filePath and runs fn on the resulting unit while
+        // holding the per-file lock. Returns false if no AST could be built.
+        // With reparse off, an already loaded unit is used as is.
+        bool withAST(const std::string& filePath,
+                     const std::function<void(clang::ASTUnit&)>& fn,
+                     bool reparse = true);
+
+        Timings timings(const std::string& filePath) const;
+        void invalidate(const std::string& filePath);
+        void clear();
+
+        // Editor contents that shadow filePath on disk for every later parse
+        // in this session. They live only in memory; nothing is written out.
+        void setUnsavedBuffer(const std::string& filePath, const std::string& contents);
+        void clearUnsavedBuffer(const std::string& filePath);
+
+        // One-shot load without preamble caching, for callers that need to
+        // own the unit. Reads through the shared file cache unless a
+        // filesystem is given.
+        static std::unique_ptr<clang::ASTUnit> loadUnit(
+            const std::string& filePath,
+            const std::vector<std::string>& compileArgs,
+            unsigned precompilePreambleAfterNParses = 0,
+            llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fileSystem = nullptr);
+
+    private:
+        struct Entry {
+            std::mutex mutex;
+            std::unique_ptr<clang::ASTUnit> unit;
+            Timings timings;
+        };
+
+        std::shared_ptr<Entry> entryFor(const std::string& filePath);
+
+        std::vector<std::string> m_compileArgs;
+        // ASTUnit keeps the filesystem it was loaded with for every Reparse,
+        // so the overlay is fixed for the session and mutated in place.
+        llvm::IntrusiveRefCntPtr<UnsavedBufferFileSystem> m_overlay;
+        mutable std::mutex m_entriesMutex;
+        std::map<std::string, std::shared_ptr<Entry>> m_entries;
+    };
+
+} // namespace CFGAnalyzer
+
+#endif // AST_SESSION_H
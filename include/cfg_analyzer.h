@@ -9,6 +9,11 @@
 #include <clang/AST/RecursiveASTVisitor.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/FrontendAction.h>
+#include <clang/Frontend/Utils.h>
+#include "ast_session.h"
+#include "code_metrics.h"
+#include "graph_arena.h"
+#include "symbol_table.h"
 #include <QString>
 #include <QMutex>
 #include <string>
@@ -16,9 +21,21 @@
 #include <set>
 #include <memory>
 #include <functional>
+#include <cstdint>
+#include <map>
+#include <vector>
 
 namespace GraphGenerator {
     class CFGGraph;
+    class FrozenGraph;
+    class StringPool;
+}
+
+namespace clang {
+namespace tooling {
+    class CompilationDatabase;
+    struct CompileCommand;
+}
 }
 
 namespace CFGAnalyzer {
@@ -26,24 +43,85 @@ namespace CFGAnalyzer {
     class CFGVisitor;
     class CFGConsumer;
     class CFGAction;
+    class SummaryCache;
 
     struct FunctionInfo {
         std::string name;
         std::string filename;
         unsigned line;
         unsigned column;
+        unsigned endLine = 0;
         bool isMethod = false;
         bool isConstructor = false;
         bool isDestructor = false;
     };
 
+    struct AnalysisOptions {
+        // Worker threads used for project and multi-file analysis; 0 picks
+        // std::thread::hardware_concurrency().
+        unsigned jobs = 0;
+
+        // Persistent per-TU summary cache used by the ClangTool-based paths
+        // (analyze, analyzeMultipleFiles, analyzeFiles, analyzeProject).
+        // Disabled when cacheDir is empty.
+        std::string cacheDir;
+        uint64_t cacheMaxBytes = 512ull * 1024 * 1024;
+
+        // analyzeFile only indexes functions; CFGs are built per function by
+        // analyzeFunction from the AST kept in the session.
+        bool lazyFunctionCFGs = false;
+
+        // Statement labels are normally slices of the parsed source, read
+        // only when shown; this pretty-prints every statement instead.
+        bool prettyPrintLabels = false;
+
+        // Where writeFunctionDots puts <function>_cfg.dot files.
+        std::string outputDir = "cfg_output";
+        // Renders a DOT per analyzed function. Batch drivers turn it off:
+        // the ClangTool paths then only build each CFG far enough to
+        // measure it.
+        bool emitFunctionDots = true;
+    };
+
+    // Last emitted CFG of one function. CFGVisitor keeps these per file so a
+    // re-analysis can skip functions whose fingerprint did not change.
+    struct FunctionSnapshot {
+        std::string name;
+        SymbolId symbol = 0;
+        uint64_t fingerprint = 0;
+        unsigned startLine = 0;
+        std::string dot;
+        std::shared_ptr<const GraphGenerator::FrozenGraph> graph;
+        // Metrics of the CFG behind dot, filled in once it was measured.
+        FunctionMetrics metrics;
+        bool measured = false;
+    };
+    using FunctionSnapshotMap = std::map<std::string, FunctionSnapshot>;
+
     struct AnalysisResult {
         std::string dotOutput;
         std::string jsonOutput;
         std::string report;
         bool success = false;
-        std::unordered_map<std::string, std::set<std::string>> functionDependencies;
+        // Call edges by SymbolId; names are looked up in SymbolTable only
+        // when the result is printed.
+        CallGraph functionDependencies;
         std::map<std::string, FunctionInfo> functions;
+        // Functions whose CFG was rebuilt (added, edited or removed) by an
+        // incremental analyzeFile; empty when nothing changed.
+        std::vector<std::string> changedFunctions;
+        // Structured graph for the GUI: the call graph of file and project
+        // analyses, or one function's CFG from analyzeFunction. Frozen, and
+        // possibly shared with the analyzer's snapshots.
+        std::shared_ptr<const GraphGenerator::FrozenGraph> graph;
+        // Metrics of every function whose CFG was built or reused; fan-in
+        // and fan-out are filled in once the call graph is complete.
+        MetricsTable metrics;
+        // DOT of every CFG built or reused, by function name, until
+        // CFGAnalyzer::writeFunctionDots puts them on disk.
+        std::map<std::string, std::string> functionDots;
+        // Arena use of the CFGs this result built; mergeResult sums it.
+        GraphGenerator::GraphArena::Stats arenaStats;
 
         AnalysisResult() = default;
         
@@ -65,7 +143,6 @@ namespace CFGAnalyzer {
     class CFGVisitor : public clang::RecursiveASTVisitor<CFGVisitor> {
         public:
             explicit CFGVisitor(clang::ASTContext* Context,
-                             const std::string& outputDir,
                              AnalysisResult& results);
 
             AnalysisResult analyzeMultipleFiles(const std::vector<std::string>& files, std::function<bool(int, int)> progressCallback = nullptr);
@@ -73,29 +150,65 @@ namespace CFGAnalyzer {
             bool VisitFunctionDecl(clang::FunctionDecl* FD);
             bool VisitCallExpr(clang::CallExpr* CE);
             void PrintFunctionDependencies() const;
-            std::unordered_map<std::string, std::set<std::string>> GetFunctionDependencies() const;
-            void FinalizeCombinedFile();
+            CallGraph GetFunctionDependencies() const;
+            // Drops snapshots of functions no longer in the file and
+            // publishes the call graph into the results.
+            void Finalize();
             
             std::string stmtToString(const clang::Stmt* S);
             std::string generateDotFromCFG(clang::FunctionDecl* FD);
             std::string escapeDotLabel(const std::string& input);
             
             AnalysisResult& getResults() { return m_results; }
+
+            // Enables per-function reuse: functions whose fingerprint matches
+            // their snapshot skip CFG construction and DOT emission.
+            void setSnapshots(FunctionSnapshotMap* snapshots) { m_snapshots = snapshots; }
+            // Pool the built CFGs intern their statement text into.
+            void setStringPool(std::shared_ptr<GraphGenerator::StringPool> strings) { m_strings = std::move(strings); }
+            void setPrettyPrintLabels(bool prettyPrint) { m_prettyPrintLabels = prettyPrint; }
+            // Keeps each function's DOT in getResults().functionDots. Without
+            // snapshots to fill, functions are then only measured.
+            void setEmitDots(bool emit) { m_emitDots = emit; }
+            uint64_t fingerprintFunction(clang::FunctionDecl* FD);
+
+            // With CFG building off, the traversal only records the function
+            // inventory and call edges. A target function gets the only CFG
+            // (in getResults().graph) and ends the traversal early.
+            void setBuildCFGs(bool build) { m_buildCFGs = build; }
+            void setTargetFunction(const std::string& name) { m_targetFunction = name; }
         
     private:
         clang::ASTContext* Context;
-        std::string OutputDir;
         std::string CurrentFunction;
         AnalysisResult& m_results;
-        std::unordered_map<std::string, std::set<std::string>> FunctionDependencies;
-        int countFunctionCalls(const std::unordered_map<std::string, std::set<std::string>>& dependencies);
+        SymbolId m_currentSymbol = 0;
+        CallGraph FunctionDependencies;
+        // Saves a USR computation per call site.
+        std::unordered_map<const clang::FunctionDecl*, SymbolId> m_symbolIds;
+        FunctionSnapshotMap* m_snapshots = nullptr;
+        std::shared_ptr<GraphGenerator::StringPool> m_strings;
+        bool m_prettyPrintLabels = false;
+        std::set<std::string> m_visitedSnapshots;
+        bool m_buildCFGs = true;
+        bool m_emitDots = true;
+        std::string m_targetFunction;
+
+        void recordFunction(clang::FunctionDecl* FD, const std::string& funcName);
+        std::string emitFunctionCFG(clang::FunctionDecl* FD, const std::string& funcName);
+        void measureFunction(clang::FunctionDecl* FD);
+        std::shared_ptr<const GraphGenerator::FrozenGraph> functionGraph(clang::FunctionDecl* FD, const std::string& funcName);
+        void dropStaleSnapshot(clang::FunctionDecl* FD, const std::string& funcName);
+        static std::string snapshotKey(clang::FunctionDecl* FD, const std::string& funcName);
+        SymbolId symbolFor(const clang::FunctionDecl* FD);
     };
 
     class CFGConsumer : public clang::ASTConsumer {
     public:
         CFGConsumer(clang::ASTContext* Context,
-                  const std::string& outputDir,
-                  AnalysisResult& results);
+                  AnalysisResult& results,
+                  bool emitDots = true,
+                  bool prettyPrintLabels = false);
         
         void HandleTranslationUnit(clang::ASTContext& Context) override;
         
@@ -105,14 +218,19 @@ namespace CFGAnalyzer {
 
     class CFGAction : public clang::ASTFrontendAction {
     public:
-        CFGAction(const std::string& outputDir, CFGAnalyzer::AnalysisResult& results);
+        CFGAction(CFGAnalyzer::AnalysisResult& results,
+                  std::shared_ptr<clang::DependencyCollector> dependencies = nullptr,
+                  bool emitDots = true,
+                  bool prettyPrintLabels = false);
         
         std::unique_ptr<clang::ASTConsumer> CreateASTConsumer(
             clang::CompilerInstance& CI, llvm::StringRef File) override;
         
     private:
-        std::string OutputDir;
         CFGAnalyzer::AnalysisResult& m_results;
+        std::shared_ptr<clang::DependencyCollector> m_dependencies;
+        bool m_emitDots;
+        bool m_prettyPrintLabels;
     };
 
     class CFGAnalyzer {
@@ -128,22 +246,75 @@ namespace CFGAnalyzer {
             std::function<bool(int, int)> progressCallback = nullptr);
     
         AnalysisResult analyzeFiles(const std::vector<std::string>& filePaths);
+
+        // Loads compile_commands.json from buildPath (a build directory or the
+        // JSON file itself) and analyzes every TU with its recorded flags.
+        AnalysisResult analyzeProject(
+            const std::string& buildPath,
+            std::function<bool(int, int)> progressCallback = nullptr);
+
+        // Builds (or reuses) the CFG of one function from the file's session
+        // AST without reparsing it; graph holds that function's CFG.
+        AnalysisResult analyzeFunction(const std::string& filename,
+                                       const std::string& functionName);
+        // Same, but parsed once with the command a compilation database
+        // recorded for the file, for drivers that analyzed it that way. The
+        // unit is not kept in the session.
+        AnalysisResult analyzeFunction(const clang::tooling::CompileCommand& command,
+                                       const std::string& functionName);
+
+        // Unsaved editor contents for filename, seen by analyzeFile and
+        // analyzeFunction until cleared. The ClangTool paths read the disk.
+        void setUnsavedBuffer(const std::string& filename, const std::string& contents);
+        void clearUnsavedBuffer(const std::string& filename);
+
+        // First-parse and reparse timings of files analyzed via analyzeFile,
+        // which keeps their ASTs and precompiled preambles in this analyzer.
+        ASTSession::Timings parseTimings(const std::string& filename) const;
+
+        void setOptions(const AnalysisOptions& options);
+        const AnalysisOptions& options() const { return m_options; }
         
         void lock() { m_analysisMutex.lock(); }
         void unlock() { m_analysisMutex.unlock(); }
-    
-    private:
+
+        // Building blocks for drivers that schedule translation units
+        // themselves (worker processes, the CLI).
+        static std::unique_ptr<clang::tooling::CompilationDatabase> defaultCompilations();
+        // buildPath is a build directory or a compile_commands.json file.
+        static std::unique_ptr<clang::tooling::CompilationDatabase> loadCompilations(
+            const std::string& buildPath, std::string& errorMessage);
+        // Analyzes one TU into functionDependencies, functions, metrics and
+        // functionDots; writes no files.
+        AnalysisResult analyzeWithDatabase(
+            const clang::tooling::CompilationDatabase& compilations,
+            const std::string& filename);
+        static void mergeResult(AnalysisResult& target, AnalysisResult&& source);
+        // Writes result.functionDots as <function>_cfg.dot files into
+        // options().outputDir and clears them. Drivers call it once, after
+        // merging their units in order. Returns the paths that could not be
+        // written, or the directory when it could not be created.
+        std::vector<std::string> writeFunctionDots(AnalysisResult& result) const;
+        static std::shared_ptr<const GraphGenerator::FrozenGraph> buildCallGraph(const AnalysisResult& result);
+        // Call graph as DOT, for export.
         std::string generateDotOutput(const AnalysisResult& result) const;
         std::string generateReport(const AnalysisResult& result) const;
+    
+    private:
+        AnalysisResult analyzeInSession(const std::string& filename);
+        std::string cacheSummary(uint64_t hitsBefore, uint64_t missesBefore) const;
+        uint64_t cacheHits() const;
+        uint64_t cacheMisses() const;
+
         static std::string getCurrentDateTime();
         std::string generateDotFromCFG(clang::FunctionDecl* FD);
         std::string stmtToString(const clang::Stmt* S);
         
-        int countFunctionCalls(const std::unordered_map<std::string, std::set<std::string>>& dependencies) const;
-        
-        std::string filterDotOutput(const std::string& dotContent);
+        int countFunctionCalls(const CallGraph& dependencies) const;
+
         
         mutable QMutex m_analysisMutex;
+        AnalysisOptions m_options;
         class Impl;
         std::unique_ptr<Impl> m_impl;
 
@@ -0,0 +1,103 @@
+#ifndef CODE_METRICS_H
+#define CODE_METRICS_H
+
+#include "symbol_table.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GraphGenerator {
+    class FrozenGraph;
+}
+
+namespace CFGAnalyzer {
+
+    enum class Metric {
+        Cyclomatic,     // E - N + 2 over the CFG, at least 1
+        Nesting,        // Deepest stack of loops and structured branches
+        Blocks,
+        Statements,
+        FanIn,          // Distinct callers
+        FanOut,         // Distinct callees
+        ExceptionEdges, // Edges from try dispatch blocks into handlers
+        Count
+    };
+
+    constexpr size_t MetricCount = static_cast<size_t>(Metric::Count);
+
+    const char* metricName(Metric metric);
+
+    struct FunctionMetrics {
+        std::array<uint32_t, MetricCount> values{};
+
+        uint32_t operator[](Metric metric) const { return values[static_cast<size_t>(metric)]; }
+        uint32_t& operator[](Metric metric) { return values[static_cast<size_t>(metric)]; }
+    };
+
+    // CFG-derived metrics of one function: everything but statements,
+    // fan-in and fan-out, which the graph does not know about.
+    FunctionMetrics measureCFG(const GraphGenerator::FrozenGraph& cfg);
+
+    // Per-function metrics, one row per SymbolId so overloads keep their
+    // own rows, stored column by column. Rows added with a CFG are measured
+    // later by measure(), in parallel; sorting and filtering only read the
+    // columns.
+    class MetricsTable {
+    public:
+        struct Range {
+            Metric metric;
+            uint32_t min = 0;
+            uint32_t max = std::numeric_limits<uint32_t>::max();
+        };
+
+        size_t size() const { return m_names.size(); }
+        bool empty() const { return m_names.empty(); }
+        SymbolId symbol(uint32_t row) const { return m_symbols[row]; }
+        // Qualified name; linkCalls() appends the parameters of overloads.
+        const std::string& name(uint32_t row) const { return m_names[row]; }
+        uint32_t value(uint32_t row, Metric metric) const {
+            return m_columns[static_cast<size_t>(metric)][row];
+        }
+        FunctionMetrics row(uint32_t row) const;
+        // Row of symbol, or npos.
+        uint32_t find(SymbolId symbol) const;
+        static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+        // Adds or replaces the row of symbol. With a cfg, the CFG-derived
+        // columns are filled in by the next measure().
+        void set(SymbolId symbol, const FunctionMetrics& metrics,
+                 std::shared_ptr<const GraphGenerator::FrozenGraph> cfg = nullptr);
+        // Rows already present are kept, as with std::map::merge.
+        void merge(MetricsTable&& other);
+
+        // Measures every pending CFG on jobs threads (0 for one per core).
+        void measure(unsigned jobs);
+        bool pending() const { return !m_pending.empty(); }
+
+        // Recomputes fan-in and fan-out from the complete call graph and
+        // names rows as SymbolNames does for it.
+        void linkCalls(const CallGraph& calls);
+
+        // Rows inside every range, ordered by sortBy (name breaks ties).
+        std::vector<uint32_t> select(Metric sortBy, bool descending = true,
+                                     const std::vector<Range>& ranges = {}) const;
+
+    private:
+        uint32_t rowFor(SymbolId symbol);
+
+        std::vector<SymbolId> m_symbols;
+        std::vector<std::string> m_names;
+        std::array<std::vector<uint32_t>, MetricCount> m_columns;
+        std::unordered_map<SymbolId, uint32_t> m_rows;
+        std::vector<std::pair<uint32_t, std::shared_ptr<const GraphGenerator::FrozenGraph>>> m_pending;
+    };
+
+} // namespace CFGAnalyzer
+
+#endif // CODE_METRICS_H
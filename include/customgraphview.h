@@ -6,6 +6,7 @@
 #include <QGraphicsEllipseItem>
 #include <QGraphicsTextItem>
 #include <QMap>
+#include <QHash>
 #include <QJsonObject>
 class CustomGraphView : public QGraphicsView {
     Q_OBJECT
@@ -78,6 +79,9 @@ private:
     QGraphicsScene* m_scene;
     QMap<QString, QGraphicsEllipseItem*> m_nodes;
     QList<QPair<QString, QString>> m_edges;
+    // Adjacency of m_edges in both directions, kept by recordEdge()
+    QHash<QString, QList<QString>> m_successors;
+    QHash<QString, QList<QString>> m_predecessors;
     QMap<QString, int> m_nodeLevels;
     double m_zoomFactor;
     bool m_panning;
@@ -90,6 +94,7 @@ private:
     void parseAndCreateEdge(int sourceId, int targetId, const QMap<QString, QString>& attributes);
 
     // Private helper methods
+    void recordEdge(const QString& from, const QString& to);
     void calculateLevels();  // Removed duplicate declaration
     void createNodeFromDot(int id, const QString& label, const QMap<QString, QString>& attributes);
     void createEdgeFromDot(int source, int target, const QMap<QString, QString>& attributes);
@@ -0,0 +1,153 @@
+#ifndef FROZEN_GRAPH_H
+#define FROZEN_GRAPH_H
+
+#include "graph_attributes.h"
+#include "string_pool.h"
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm {
+    class BitVector;
+}
+
+namespace GraphGenerator {
+
+    class CFGGraph;
+    class DominatorTree;
+    class ControlDependence;
+    class RegionForest;
+    class StronglyConnectedComponents;
+    struct GraphAnalysisCache;
+
+    // Text escaped for a double-quoted DOT string; newlines become \n.
+    QString escapeDot(const QString& text);
+
+    // Read-only compressed-sparse-row form of a finished CFGGraph. Nodes sit
+    // at dense indices 0..nodeCount()-1 in ascending id order; the successors
+    // and predecessors of node i are slices of flat index arrays, and node
+    // attributes, including the NodeFlags and EdgeFlags words, are stored
+    // column-wise. Analysis results publish graphs in this form, so every
+    // reader walks contiguous memory.
+    class FrozenGraph {
+    public:
+        static constexpr uint32_t npos = ~0u;
+
+        template <typename T>
+        class Range {
+        public:
+            Range(const T* first, const T* last) : m_first(first), m_last(last) {}
+            const T* begin() const { return m_first; }
+            const T* end() const { return m_last; }
+            size_t size() const { return static_cast<size_t>(m_last - m_first); }
+            bool empty() const { return m_first == m_last; }
+            const T& operator[](size_t i) const { return m_first[i]; }
+
+        private:
+            const T* m_first;
+            const T* m_last;
+        };
+
+        FrozenGraph();
+
+        static std::shared_ptr<const FrozenGraph> freeze(const CFGGraph& graph);
+
+        size_t nodeCount() const { return m_ids.size(); }
+        size_t edgeCount() const { return m_successors.size(); }
+        bool empty() const { return m_ids.empty(); }
+
+        int id(uint32_t index) const { return m_ids[index]; }
+        // Dense index of a node id, or npos.
+        uint32_t indexOf(int id) const;
+        bool contains(int id) const { return indexOf(id) != npos; }
+
+        // Edges are numbered in successor order: the out-edges of node i are
+        // firstEdge(i) .. firstEdge(i + 1) - 1 and lead to successors(i).
+        Range<uint32_t> successors(uint32_t index) const {
+            return slice(m_successors, m_successorOffsets, index);
+        }
+        Range<uint32_t> predecessors(uint32_t index) const {
+            return slice(m_predecessors, m_predecessorOffsets, index);
+        }
+        // Numbers of the in-edges of node i, parallel to predecessors(i).
+        Range<uint32_t> predecessorEdges(uint32_t index) const {
+            return slice(m_predecessorEdges, m_predecessorOffsets, index);
+        }
+        uint32_t firstEdge(uint32_t index) const { return m_successorOffsets[index]; }
+        EdgeFlags edgeFlags(uint32_t edge) const { return m_edgeFlags[edge]; }
+        uint32_t edgeIndex(uint32_t from, uint32_t to) const;
+
+        NodeFlags nodeFlags(uint32_t index) const { return m_nodeFlags[index]; }
+        const QString& label(uint32_t index) const { return m_labels[index]; }
+        const QString& functionName(uint32_t index) const { return m_functionNames[index]; }
+        const QString& filename(uint32_t index) const { return m_filenames[index]; }
+        int startLine(uint32_t index) const { return m_startLines[index]; }
+        int endLine(uint32_t index) const { return m_endLines[index]; }
+        // Unescaped statement text, sliced from source or interned.
+        Range<StatementText> statements(uint32_t index) const {
+            return slice(m_statements, m_statementOffsets, index);
+        }
+
+        // Id-based lookups for callers holding node ids (SVG elements, menus).
+        bool isExceptionEdge(int fromId, int toId) const;
+        bool hasNodeFlag(int id, NodeFlags flag) const;
+
+        std::string toDot() const;
+        // Only the nodes whose bit is set, and the edges between them.
+        std::string toDot(const llvm::BitVector& visible) const;
+        // Quotient of the graph: node i is drawn as representative[i], or
+        // not at all when that is npos. Nodes standing in for others are
+        // drawn expandable, and edges leaving the nodes they stand for are
+        // drawn from them, dashed.
+        std::string toDot(const std::vector<uint32_t>& representative) const;
+
+        // Copy whose source ranges are moved by delta lines.
+        std::shared_ptr<const FrozenGraph> withLinesShifted(int delta) const;
+
+        // Structural analyses (graph_analysis.h), computed on first use and
+        // cached with the graph. Safe to call from several threads.
+        const DominatorTree& dominators() const;
+        const DominatorTree& postDominators() const;
+        const ControlDependence& controlDependence() const;
+        const RegionForest& regions() const;
+        const StronglyConnectedComponents& components() const;
+
+    private:
+        std::string writeDot(const llvm::BitVector* visible,
+                             const std::vector<uint32_t>* representative) const;
+
+        template <typename T>
+        static Range<T> slice(const std::vector<T>& values, const std::vector<uint32_t>& offsets,
+                              uint32_t index) {
+            return Range<T>(values.data() + offsets[index], values.data() + offsets[index + 1]);
+        }
+
+        std::vector<int> m_ids;
+
+        std::vector<uint32_t> m_successorOffsets;
+        std::vector<uint32_t> m_successors;
+        std::vector<EdgeFlags> m_edgeFlags;
+        std::vector<uint32_t> m_predecessorOffsets;
+        std::vector<uint32_t> m_predecessors;
+        std::vector<uint32_t> m_predecessorEdges;
+
+        std::vector<NodeFlags> m_nodeFlags;
+        std::vector<QString> m_labels;
+        std::vector<QString> m_functionNames;
+        std::vector<QString> m_filenames;
+        std::vector<int> m_startLines;
+        std::vector<int> m_endLines;
+        std::vector<uint32_t> m_statementOffsets;
+        std::vector<StatementText> m_statements;
+        // Owns the text and source files behind m_statements.
+        std::shared_ptr<const StringPool> m_strings;
+        // Shared by copies, which keep the same nodes and edges.
+        std::shared_ptr<GraphAnalysisCache> m_analyses;
+    };
+
+} // namespace GraphGenerator
+
+#endif // FROZEN_GRAPH_H
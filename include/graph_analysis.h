@@ -0,0 +1,274 @@
+#ifndef GRAPH_ANALYSIS_H
+#define GRAPH_ANALYSIS_H
+
+#include "frozen_graph.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace GraphGenerator {
+
+    // Dominator tree of a FrozenGraph, or with Direction::Post its
+    // post-dominator tree (dominators of the reversed graph). Built with the
+    // Cooper-Harvey-Kennedy iterative algorithm over the graph's dense
+    // indices. A virtual root is joined to every entry (node without
+    // predecessors), or for post-dominators to every exit; nodes it still
+    // cannot reach, such as the body of an infinite loop, are joined to it
+    // too, so every node has a place in the tree.
+    class DominatorTree {
+    public:
+        enum class Direction { Forward, Post };
+        using Range = FrozenGraph::Range<uint32_t>;
+
+        DominatorTree(const FrozenGraph& graph, Direction direction);
+
+        Direction direction() const { return m_direction; }
+
+        // Immediate (post-)dominator of index, or FrozenGraph::npos when it
+        // hangs off the virtual root.
+        uint32_t idom(uint32_t index) const {
+            return m_idom[index] == m_root ? FrozenGraph::npos : m_idom[index];
+        }
+        // Whether a (post-)dominates b; a node dominates itself.
+        bool dominates(uint32_t a, uint32_t b) const {
+            return m_preorder[a] <= m_preorder[b] && m_preorder[b] <= m_lastDescendant[a];
+        }
+        // Nodes immediately (post-)dominated by index.
+        Range children(uint32_t index) const { return slice(m_children, m_childOffsets, index); }
+        // Nodes where the (post-)dominance of index ends.
+        Range frontier(uint32_t index) const { return slice(m_frontier, m_frontierOffsets, index); }
+
+    private:
+        static Range slice(const std::vector<uint32_t>& values, const std::vector<uint32_t>& offsets,
+                           uint32_t index) {
+            return Range(values.data() + offsets[index], values.data() + offsets[index + 1]);
+        }
+
+        Direction m_direction;
+        // Index of the virtual root, one past the last node.
+        uint32_t m_root;
+        std::vector<uint32_t> m_idom;
+        // Dominator-tree preorder numbers; the subtree of v is
+        // m_preorder[v] .. m_lastDescendant[v].
+        std::vector<uint32_t> m_preorder;
+        std::vector<uint32_t> m_lastDescendant;
+        std::vector<uint32_t> m_childOffsets;
+        std::vector<uint32_t> m_children;
+        std::vector<uint32_t> m_frontierOffsets;
+        std::vector<uint32_t> m_frontier;
+    };
+
+    // Control dependence derived from the post-dominance frontiers: node Y
+    // depends on branch X when X decides whether Y runs, i.e. X lies in the
+    // post-dominance frontier of Y.
+    class ControlDependence {
+    public:
+        using Range = FrozenGraph::Range<uint32_t>;
+
+        ControlDependence(const DominatorTree& postDominators, size_t nodeCount);
+
+        // Nodes whose execution the branch at index decides.
+        Range dependents(uint32_t index) const {
+            return Range(m_dependents.data() + m_dependentOffsets[index],
+                         m_dependents.data() + m_dependentOffsets[index + 1]);
+        }
+        // Branches that decide whether index runs.
+        Range controllers(uint32_t index) const {
+            return Range(m_controllers.data() + m_controllerOffsets[index],
+                         m_controllers.data() + m_controllerOffsets[index + 1]);
+        }
+
+    private:
+        std::vector<uint32_t> m_dependentOffsets;
+        std::vector<uint32_t> m_dependents;
+        std::vector<uint32_t> m_controllerOffsets;
+        std::vector<uint32_t> m_controllers;
+    };
+
+    // Loop-nesting forest extended with single-entry single-exit branch
+    // regions, the units the viewer folds. A loop is a natural loop: its
+    // header plus every node reaching a back edge (an edge into a dominator)
+    // without passing the header; loops sharing a header are merged. A
+    // conditional is a branch with the nodes it dominates up to, and not
+    // including, its immediate post-dominator, provided the branch also
+    // dominates that post-dominator and nothing enters in between. Regions
+    // either nest or are disjoint: a candidate that partially overlaps a
+    // larger region, or covers exactly its nodes, is dropped. Cycles with
+    // no dominating header (irreducible flow) form no loop.
+    //
+    // Regions are numbered outermost first, so a parent always precedes its
+    // children.
+    class RegionForest {
+    public:
+        enum class Kind { Loop, Conditional };
+
+        struct Region {
+            Kind kind;
+            uint32_t entry;
+            // Where control leaves a conditional; npos for loops.
+            uint32_t exit;
+            // Enclosing region, or npos.
+            uint32_t parent;
+            // 0 for outermost regions.
+            uint32_t depth;
+        };
+
+        using Range = FrozenGraph::Range<uint32_t>;
+
+        RegionForest(const FrozenGraph& graph, const DominatorTree& dominators,
+                     const DominatorTree& postDominators);
+
+        size_t size() const { return m_regions.size(); }
+        bool empty() const { return m_regions.empty(); }
+        const Region& operator[](uint32_t region) const { return m_regions[region]; }
+
+        // Nodes of region, entry included, ascending.
+        Range nodes(uint32_t region) const {
+            return Range(m_nodes.data() + m_nodeOffsets[region],
+                         m_nodes.data() + m_nodeOffsets[region + 1]);
+        }
+        // Innermost region containing index, or FrozenGraph::npos.
+        uint32_t innermost(uint32_t index) const { return m_innermost[index]; }
+        // Outermost region entered at index, or FrozenGraph::npos.
+        uint32_t headedBy(uint32_t index) const { return m_headed[index]; }
+
+    private:
+        std::vector<Region> m_regions;
+        std::vector<uint32_t> m_nodeOffsets;
+        std::vector<uint32_t> m_nodes;
+        std::vector<uint32_t> m_innermost;
+        std::vector<uint32_t> m_headed;
+    };
+
+    // Strongly connected components and the condensation DAG between them,
+    // found by an iterative Tarjan walk so that deep call chains cannot
+    // overflow the stack. Components are numbered by their lowest node
+    // index; call graph nodes are indexed in function name order, so the
+    // numbers are stable from run to run.
+    class StronglyConnectedComponents {
+    public:
+        using Range = FrozenGraph::Range<uint32_t>;
+
+        explicit StronglyConnectedComponents(const FrozenGraph& graph);
+
+        size_t size() const { return m_cyclic.size(); }
+        uint32_t componentOf(uint32_t index) const { return m_component[index]; }
+        // Nodes of component, ascending.
+        Range members(uint32_t component) const {
+            return Range(m_members.data() + m_memberOffsets[component],
+                         m_members.data() + m_memberOffsets[component + 1]);
+        }
+        // Condensation edges: the other components component has an edge
+        // into, ascending.
+        Range successors(uint32_t component) const {
+            return Range(m_successors.data() + m_successorOffsets[component],
+                         m_successors.data() + m_successorOffsets[component + 1]);
+        }
+        // Several nodes, or one node with an edge to itself.
+        bool isCyclic(uint32_t component) const { return m_cyclic[component]; }
+        size_t cyclicCount() const;
+
+    private:
+        std::vector<uint32_t> m_component;
+        std::vector<uint32_t> m_memberOffsets;
+        std::vector<uint32_t> m_members;
+        std::vector<uint32_t> m_successorOffsets;
+        std::vector<uint32_t> m_successors;
+        std::vector<char> m_cyclic;
+    };
+
+    // Simple (loop-free) paths from one node to another, produced one per
+    // next() call. Order::Shortest yields them by increasing weight with
+    // Yen's algorithm, so the first k calls are the k shortest paths;
+    // Order::DepthFirst walks successors in order and is cheaper per path.
+    // Enumeration stops after maxPaths paths or maxSteps edge visits in
+    // total, and paths of more than maxLength nodes are skipped, so a loopy
+    // graph cannot make a caller wait on its path explosion.
+    class PathEnumerator {
+    public:
+        enum class Order { Shortest, DepthFirst };
+
+        struct Options {
+            Order order = Order::Shortest;
+            size_t maxPaths = 16;
+            size_t maxLength = 256;
+            size_t maxSteps = 1 << 20;
+            // Non-negative weight of an edge index; every edge weighs 1
+            // when empty.
+            std::function<double(uint32_t edge)> weight;
+        };
+
+        struct Path {
+            std::vector<uint32_t> nodes;
+            double weight = 0;
+        };
+
+        PathEnumerator(const FrozenGraph& graph, uint32_t from, uint32_t to, Options options);
+        PathEnumerator(const FrozenGraph& graph, uint32_t from, uint32_t to)
+            : PathEnumerator(graph, from, to, Options()) {}
+
+        // Next path, from first to last node; false once enumeration ended.
+        bool next(Path& path);
+        // Paths returned so far.
+        size_t count() const { return m_count; }
+        // Enumeration stopped at maxPaths with another path left, or at
+        // maxSteps, where more paths may exist.
+        bool truncated() const { return m_truncated; }
+
+    private:
+        double weightOf(uint32_t edge) const;
+        double pathWeight(const std::vector<uint32_t>& nodes) const;
+        bool step();
+        bool advance(Path& path);
+        bool shortestPath(uint32_t from, Path& path);
+        bool nextShortest(Path& path);
+        bool nextDepthFirst(Path& path);
+
+        const FrozenGraph& m_graph;
+        uint32_t m_from;
+        uint32_t m_to;
+        Options m_options;
+        size_t m_count = 0;
+        size_t m_steps = 0;
+        bool m_started = false;
+        bool m_done = false;
+        bool m_truncated = false;
+
+        // Yen: paths returned so far and candidates ordered by weight.
+        std::vector<Path> m_accepted;
+        std::set<std::pair<double, std::vector<uint32_t>>> m_candidates;
+        std::vector<char> m_blockedNodes;
+        std::vector<char> m_blockedEdges;
+        std::vector<double> m_distance;
+        std::vector<uint32_t> m_parent;
+
+        // Depth-first: the current path and the next successor slot to try
+        // at each of its nodes.
+        std::vector<std::pair<uint32_t, uint32_t>> m_stack;
+        std::vector<char> m_onPath;
+        std::vector<char> m_reachesTarget;
+    };
+
+    // Analyses a FrozenGraph computes on first use and keeps for its
+    // lifetime. Copies that keep the structure (withLinesShifted) share it.
+    struct GraphAnalysisCache {
+        std::once_flag dominatorsOnce;
+        std::once_flag postDominatorsOnce;
+        std::once_flag controlDependenceOnce;
+        std::once_flag regionsOnce;
+        std::once_flag componentsOnce;
+        std::unique_ptr<const DominatorTree> dominators;
+        std::unique_ptr<const DominatorTree> postDominators;
+        std::unique_ptr<const ControlDependence> controlDependence;
+        std::unique_ptr<const RegionForest> regions;
+        std::unique_ptr<const StronglyConnectedComponents> components;
+    };
+
+} // namespace GraphGenerator
+
+#endif // GRAPH_ANALYSIS_H
@@ -0,0 +1,69 @@
+#ifndef GRAPH_ARENA_H
+#define GRAPH_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace GraphGenerator {
+
+    // Monotonic memory for the containers of a CFGGraph under construction:
+    // node maps, edge maps and statement lists are carved out of a few large
+    // blocks and all returned at once when the arena is destroyed, instead
+    // of one tree node at a time. An arena is filled by one thread at a time.
+    class GraphArena : public std::pmr::memory_resource {
+    public:
+        struct Stats {
+            // Allocations served from the arena; each used to be one heap
+            // allocation and one free.
+            uint64_t allocations = 0;
+            // Heap blocks the arena took to serve them, and their size.
+            uint64_t blocks = 0;
+            uint64_t bytes = 0;
+
+            Stats& operator+=(const Stats& other) {
+                allocations += other.allocations;
+                blocks += other.blocks;
+                bytes += other.bytes;
+                return *this;
+            }
+        };
+
+        explicit GraphArena(size_t initialSize = 16 * 1024);
+        GraphArena(const GraphArena&) = delete;
+        GraphArena& operator=(const GraphArena&) = delete;
+
+        // Counts of this arena only; a run sums the arenas of the graphs it
+        // built, so concurrent runs do not see each other's allocations.
+        Stats stats() const { return m_stats; }
+
+    private:
+        // Counts the blocks the monotonic buffer takes from the heap.
+        class Upstream : public std::pmr::memory_resource {
+        public:
+            explicit Upstream(Stats& stats) : m_stats(stats) {}
+
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+
+            Stats& m_stats;
+        };
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        Stats m_stats;
+        Upstream m_upstream;
+        std::pmr::monotonic_buffer_resource m_buffer;
+    };
+
+} // namespace GraphGenerator
+
+#endif // GRAPH_ARENA_H
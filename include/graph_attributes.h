@@ -0,0 +1,78 @@
+#ifndef GRAPH_ATTRIBUTES_H
+#define GRAPH_ATTRIBUTES_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace GraphGenerator {
+
+    // Node and edge attributes are bits of one flag word stored inline with
+    // each node and edge. The built-in bits below are registered in this
+    // order; when several styled flags are set, the lowest bit wins.
+    using NodeFlags = uint32_t;
+    using EdgeFlags = uint32_t;
+
+    enum NodeFlag : NodeFlags {
+        Expandable = 1u << 0,
+        TryBlock = 1u << 1,
+        ThrowsException = 1u << 2
+    };
+
+    enum EdgeFlag : EdgeFlags {
+        ExceptionEdge = 1u << 0,
+        // Branches of a two-way conditional terminator.
+        TrueBranch = 1u << 1,
+        FalseBranch = 1u << 2
+    };
+
+    // Process-wide names and DOT styles of the flag bits. Analyses add their
+    // own attributes (loop header, unreachable, ...) with registerNodeFlag or
+    // registerEdgeFlag and get the next free bit; registering an existing
+    // name returns its bit. Lookups are lock-free.
+    class AttributeRegistry {
+    public:
+        static constexpr unsigned kMaxFlags = 32;
+
+        struct Attribute {
+            std::string name;
+            // Appended to the node or edge attribute list in DOT output.
+            std::string dotStyle;
+        };
+
+        static AttributeRegistry& instance();
+
+        // Returns 0 once all kMaxFlags bits are taken.
+        NodeFlags registerNodeFlag(const std::string& name, const std::string& dotStyle = std::string());
+        EdgeFlags registerEdgeFlag(const std::string& name, const std::string& dotStyle = std::string());
+
+        // DOT style of the lowest styled bit set in flags, or an empty string.
+        const std::string& nodeStyle(NodeFlags flags) const { return m_nodes.style(flags); }
+        const std::string& edgeStyle(EdgeFlags flags) const { return m_edges.style(flags); }
+
+        const Attribute* nodeAttribute(NodeFlags bit) const { return m_nodes.find(bit); }
+        const Attribute* edgeAttribute(EdgeFlags bit) const { return m_edges.find(bit); }
+
+    private:
+        struct Table {
+            std::array<Attribute, kMaxFlags> attributes;
+            std::atomic<unsigned> count{0};
+            std::atomic<uint32_t> styledMask{0};
+
+            uint32_t add(const std::string& name, const std::string& dotStyle);
+            const std::string& style(uint32_t flags) const;
+            const Attribute* find(uint32_t bit) const;
+        };
+
+        AttributeRegistry();
+
+        std::mutex m_mutex;
+        Table m_nodes;
+        Table m_edges;
+    };
+
+} // namespace GraphGenerator
+
+#endif // GRAPH_ATTRIBUTES_H
@@ -8,11 +8,16 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory_resource>
 #include <clang/AST/Stmt.h>
 #include <clang/Analysis/CFG.h>
 #include <clang/AST/Decl.h>
 #include <nlohmann/json.hpp>
 #include <QString>
+#include "frozen_graph.h"
+#include "graph_arena.h"
+#include "graph_attributes.h"
+#include "string_pool.h"
 
 namespace GraphGenerator {
     using json = nlohmann::json;
@@ -22,20 +27,38 @@ namespace GraphGenerator {
 
     std::unique_ptr<CFGGraph> generateCFG(const std::vector<std::string>& sourceFiles);
     std::unique_ptr<CFGGraph> generateCFGFromStatements(const std::vector<std::string>& statements);
-    std::unique_ptr<CFGGraph> generateCFG(const clang::FunctionDecl* FD);
+    // How statement labels are produced. SourceSlice records only a byte
+    // range of the parsed source and reads it when the label is shown;
+    // statements without a contiguous spelling (macro expansions) are still
+    // pretty-printed. PrettyPrint runs Stmt::printPretty on every statement.
+    enum class LabelMode { SourceSlice, PrettyPrint };
+
+    // Statement text is interned into strings when given, so graphs built in
+    // one analysis session share a single pool.
+    std::unique_ptr<CFGGraph> generateCFG(const clang::FunctionDecl* FD,
+                                          std::shared_ptr<StringPool> strings = nullptr,
+                                          LabelMode labelMode = LabelMode::SourceSlice);
     std::unique_ptr<CFGGraph> generateCustomCFG(const clang::FunctionDecl* FD);
     std::unique_ptr<CFGGraph> generateCFG(const Parser::FunctionInfo& functionInfo, clang::ASTContext* context);
     std::string getStmtString(const clang::Stmt* S);
+    // Spelling of S in its source file, or empty if it has none (macro
+    // expansions, invalid locations). Points into the SourceManager's buffer.
+    llvm::StringRef getStmtSourceText(const clang::Stmt* S, const clang::ASTContext& context);
 
     using Graph = CFGGraph;
 
+    // Containers of a node come from the arena of the graph holding it.
     struct CFGNode {
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
         int id;
         QString label;
         QString functionName;
         QString filename;
-        std::vector<QString> statements;
-        std::set<int> successors;
+        std::pmr::vector<StatementText> statements;
+        // Successor id -> flags of the edge to it
+        std::pmr::map<int, EdgeFlags> successors;
+        NodeFlags flags = 0;
         bool expanded = false;
         bool visible = false;
         QString sourceLocation; 
@@ -43,8 +66,32 @@ namespace GraphGenerator {
         int endLine = -1;
         
         CFGNode() : id(-1) {}
-        CFGNode(int nodeId, const QString& lbl = "", const QString& fnName = "") 
+        explicit CFGNode(const allocator_type& alloc)
+            : id(-1), statements(alloc), successors(alloc) {}
+        CFGNode(int nodeId, const QString& lbl = "", const QString& fnName = "")
             : id(nodeId), label(lbl), functionName(fnName) {}
+        CFGNode(std::allocator_arg_t, const allocator_type& alloc,
+                int nodeId, const QString& lbl = "", const QString& fnName = "")
+            : id(nodeId), label(lbl), functionName(fnName), statements(alloc), successors(alloc) {}
+        CFGNode(const CFGNode&) = default;
+        CFGNode(CFGNode&&) = default;
+        CFGNode(const CFGNode& other, const allocator_type& alloc)
+            : id(other.id), label(other.label), functionName(other.functionName),
+              filename(other.filename), statements(other.statements, alloc),
+              successors(other.successors, alloc), flags(other.flags),
+              expanded(other.expanded), visible(other.visible),
+              sourceLocation(other.sourceLocation), startLine(other.startLine),
+              endLine(other.endLine) {}
+        CFGNode(CFGNode&& other, const allocator_type& alloc)
+            : id(other.id), label(std::move(other.label)),
+              functionName(std::move(other.functionName)), filename(std::move(other.filename)),
+              statements(std::move(other.statements), alloc),
+              successors(std::move(other.successors), alloc), flags(other.flags),
+              expanded(other.expanded), visible(other.visible),
+              sourceLocation(std::move(other.sourceLocation)), startLine(other.startLine),
+              endLine(other.endLine) {}
+        CFGNode& operator=(const CFGNode&) = default;
+        CFGNode& operator=(CFGNode&&) = default;
     
         void setSourceRange(const QString& file, int start, int end) {
             filename = file;
@@ -65,28 +112,55 @@ namespace GraphGenerator {
     };
 
     class CFGGraph {
-        std::set<int> expandableNodes;
     public:
+        // Without a pool the graph interns into one of its own. Nodes, edges
+        // and statement lists live in a GraphArena owned by the graph and
+        // are freed in one step with it.
+        explicit CFGGraph(std::shared_ptr<StringPool> strings = nullptr)
+            : m_strings(strings ? std::move(strings) : std::make_shared<StringPool>()),
+              m_arena(std::make_unique<GraphArena>()),
+              nodes(m_arena.get()),
+              predecessors(m_arena.get()) {}
+        CFGGraph(const CFGGraph&) = delete;
+        CFGGraph& operator=(const CFGGraph&) = delete;
+
+        const std::shared_ptr<StringPool>& strings() const { return m_strings; }
+        GraphArena::Stats arenaStats() const { return m_arena->stats(); }
 
+        // Immutable CSR snapshot; graphs are frozen once built and published
+        // in that form.
+        std::shared_ptr<const FrozenGraph> freeze() const { return FrozenGraph::freeze(*this); }
+
+        // DOT text for rendering and export. Nodes are named and tagged
+        // "node<id>" so SVG elements map back to graph ids.
+        std::string toDot() const { return freeze()->toDot(); }
         void writeToDotFile(const QString& filename) const;
         void writeToJsonFile(const QString& filename, const json& astJson, const json& functionCallJson);
         QString getNodeLabel(int nodeID) const;
         
+        // Statements are stored unescaped; writers escape on output.
         void addStatement(int nodeID, const QString& stmt);
+        void addStatement(int nodeID, llvm::StringRef stmt);
+        void addStatement(int nodeID, const StatementText& stmt);
         void addExceptionEdge(int sourceID, int targetID);
-        bool isExceptionEdge(int sourceID, int targetID) const;
-        void markNodeAsTryBlock(int nodeID);
-        void markNodeAsThrowingException(int nodeID);
-        bool isNodeTryBlock(int nodeID) const;
-        bool isNodeThrowingException(int nodeID) const;
-
-        void markNodeAsExpandable(int nodeID) {
-            expandableNodes.insert(nodeID);
-        }
-        
-        bool isNodeExpandable(int nodeID) const {
-            return expandableNodes.find(nodeID) != expandableNodes.end();
+
+        // Flag words live on the node and on the edge; flag bits are the
+        // NodeFlag/EdgeFlag values or ones from AttributeRegistry.
+        void setNodeFlags(int nodeID, NodeFlags flags);
+        NodeFlags nodeFlags(int nodeID) const;
+        // The edge is added if missing.
+        void setEdgeFlags(int sourceID, int targetID, EdgeFlags flags);
+        EdgeFlags edgeFlags(int sourceID, int targetID) const;
+
+        bool isExceptionEdge(int sourceID, int targetID) const {
+            return edgeFlags(sourceID, targetID) & ExceptionEdge;
         }
+        void markNodeAsTryBlock(int nodeID) { setNodeFlags(nodeID, TryBlock); }
+        void markNodeAsThrowingException(int nodeID) { setNodeFlags(nodeID, ThrowsException); }
+        bool isNodeTryBlock(int nodeID) const { return nodeFlags(nodeID) & TryBlock; }
+        bool isNodeThrowingException(int nodeID) const { return nodeFlags(nodeID) & ThrowsException; }
+        void markNodeAsExpandable(int nodeID) { setNodeFlags(nodeID, Expandable); }
+        bool isNodeExpandable(int nodeID) const { return nodeFlags(nodeID) & Expandable; }
 
         void setNodeSourceLocation(int nodeId, const QString& location) {
             auto it = nodes.find(nodeId);
@@ -151,25 +225,30 @@ namespace GraphGenerator {
         // Existing methods remain the same
         void addNode(int nodeID) {
             if (nodes.find(nodeID) == nodes.end()) {
-                nodes[nodeID] = CFGNode(nodeID, "Block " + QString::number(nodeID));
+                nodes.try_emplace(nodeID, nodeID, "Block " + QString::number(nodeID));
             }
         }
         
         void addStatementToNode(int nodeID, const QString& stmt) {
-            if (nodes.find(nodeID) == nodes.end()) {
-                addNode(nodeID);
-            }
-            nodes[nodeID].statements.push_back(stmt);
+            addStatement(nodeID, stmt);
         }       
         
         void addEdge(int fromID, int toID) {
             if (nodes.find(fromID) == nodes.end()) {
                 addNode(fromID);
             }
-            nodes[fromID].successors.insert(toID);
+            nodes[fromID].successors.emplace(toID, 0);
+            predecessors[toID].insert(fromID);
+        }
+
+        // Sources of the edges into nodeID, kept in step with successors.
+        const std::pmr::set<int>& getPredecessors(int nodeID) const {
+            static const std::pmr::set<int> none;
+            auto it = predecessors.find(nodeID);
+            return it != predecessors.end() ? it->second : none;
         }
         
-        const std::map<int, CFGNode>& getNodes() const noexcept { 
+        const std::pmr::map<int, CFGNode>& getNodes() const noexcept { 
             return nodes; 
         }
 
@@ -179,13 +258,14 @@ namespace GraphGenerator {
         }
         
     private:
+        std::shared_ptr<StringPool> m_strings;
         QString currentFilename;
 
         std::unordered_map<int, std::pair<int, int>> m_nodeSourceRanges;
-        std::map<int, CFGNode> nodes;
-        std::set<std::pair<int, int>> exceptionEdges;
-        std::set<int> tryBlocks;
-        std::set<int> throwingBlocks;
+        // Declared before the containers so it outlives them.
+        std::unique_ptr<GraphArena> m_arena;
+        std::pmr::map<int, CFGNode> nodes;
+        std::pmr::map<int, std::pmr::set<int>> predecessors;
     };
 }
 
@@ -0,0 +1,209 @@
+#ifndef GRAPH_VIEW_H
+#define GRAPH_VIEW_H
+
+#include "frozen_graph.h"
+#include <llvm/ADT/BitVector.h>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GraphGenerator {
+
+    // A subset of the nodes of a FrozenGraph that shares the graph's
+    // storage: filters, function slices and the progressively revealed part
+    // of a graph are a bitmap over its node indices rather than a copy. An
+    // edge is in the view when both of its ends are. Indices, labels and
+    // flags are those of the underlying graph, reached through operator->.
+    //
+    // A view of a whole graph carries no bitmap. Once one is needed it is
+    // sized to the graph, and narrowing or re-selecting reuses it, so
+    // switching the function or filter of a view does not allocate.
+    //
+    // Regions of graph()->regions() and cyclic components of
+    // graph()->components() can also be collapsed: their nodes are folded
+    // into the region's entry node, or the component's lowest node, and
+    // leave the view, whatever the visible set says, until expanded again.
+    // With every cycle collapsed the view is the condensation DAG.
+    class CFGGraphView {
+    public:
+        class NodeIterator;
+        class NodeRange;
+        class SuccessorIterator;
+        class SuccessorRange;
+
+        CFGGraphView() = default;
+        // Every node of graph. Implicit, so a graph can be passed wherever a
+        // view is consumed.
+        CFGGraphView(std::shared_ptr<const FrozenGraph> graph) : m_graph(std::move(graph)) {}
+
+        const std::shared_ptr<const FrozenGraph>& graph() const { return m_graph; }
+        const FrozenGraph* operator->() const { return m_graph.get(); }
+        const FrozenGraph& operator*() const { return *m_graph; }
+        explicit operator bool() const { return m_graph != nullptr; }
+
+        // Rebinds the view to graph with all or none of its nodes shown.
+        void reset(std::shared_ptr<const FrozenGraph> graph, bool visible = true);
+        void showAll();
+        void hideAll();
+        void show(uint32_t index);
+        void hide(uint32_t index);
+        // False if the graph has no node with that id.
+        bool showId(int id);
+
+        // Keeps the nodes of the view for which pred(index) holds.
+        template <typename Predicate>
+        void filter(Predicate pred) {
+            if (!m_graph) return;
+            materialize();
+            for (int i = m_visible.find_first(); i != -1; i = m_visible.find_next(i)) {
+                if (!pred(static_cast<uint32_t>(i))) {
+                    m_visible.reset(i);
+                }
+            }
+        }
+        // Shows exactly the nodes of one function.
+        void selectFunction(const QString& functionName);
+
+        void collapse(uint32_t region);
+        void expand(uint32_t region);
+        void collapseAll();
+        // Expands regions and components alike.
+        void expandAll();
+        bool isCollapsed(uint32_t region) const {
+            return region < m_collapsed.size() && m_collapsed.test(region);
+        }
+        void collapseComponent(uint32_t component);
+        void expandComponent(uint32_t component);
+        void collapseCycles();
+        bool isComponentCollapsed(uint32_t component) const {
+            return component < m_collapsedComponents.size() && m_collapsedComponents.test(component);
+        }
+        // Entry node a collapsed region folds index into, or npos.
+        uint32_t foldedInto(uint32_t index) const {
+            return m_foldedInto.empty() ? FrozenGraph::npos : m_foldedInto[index];
+        }
+
+        bool isComplete() const { return m_complete; }
+        bool contains(uint32_t index) const {
+            return (m_complete || m_visible.test(index)) && foldedInto(index) == FrozenGraph::npos;
+        }
+        bool containsId(int id) const;
+        // Nodes in the view.
+        size_t nodeCount() const;
+        bool empty() const { return nodeCount() == 0; }
+
+        // Indices of the nodes in the view, ascending.
+        NodeRange nodes() const;
+        // Successors of index that are in the view.
+        SuccessorRange successors(uint32_t index) const;
+
+        // DOT of the nodes in the view and the edges between them, in the
+        // format of FrozenGraph::toDot. Collapsed regions are drawn as their
+        // entry node, with the edges leaving them.
+        std::string toDot() const;
+
+        class NodeIterator {
+        public:
+            uint32_t operator*() const { return static_cast<uint32_t>(m_index); }
+            NodeIterator& operator++() {
+                m_index = m_view->next(m_index);
+                return *this;
+            }
+            bool operator==(const NodeIterator& other) const { return m_index == other.m_index; }
+            bool operator!=(const NodeIterator& other) const { return m_index != other.m_index; }
+
+        private:
+            friend class CFGGraphView;
+            NodeIterator(const CFGGraphView* view, int index) : m_view(view), m_index(index) {}
+
+            const CFGGraphView* m_view;
+            int m_index;
+        };
+
+        class NodeRange {
+        public:
+            NodeIterator begin() const { return m_begin; }
+            NodeIterator end() const { return m_end; }
+
+        private:
+            friend class CFGGraphView;
+            NodeRange(NodeIterator begin, NodeIterator end) : m_begin(begin), m_end(end) {}
+
+            NodeIterator m_begin;
+            NodeIterator m_end;
+        };
+
+        class SuccessorIterator {
+        public:
+            uint32_t operator*() const { return *m_position; }
+            // Number of the edge to the current successor in the graph.
+            uint32_t edge() const { return m_firstEdge + static_cast<uint32_t>(m_position - m_first); }
+            SuccessorIterator& operator++() {
+                ++m_position;
+                skipHidden();
+                return *this;
+            }
+            bool operator==(const SuccessorIterator& other) const { return m_position == other.m_position; }
+            bool operator!=(const SuccessorIterator& other) const { return m_position != other.m_position; }
+
+        private:
+            friend class CFGGraphView;
+            SuccessorIterator(const CFGGraphView* view, const uint32_t* first, const uint32_t* position,
+                              const uint32_t* last, uint32_t firstEdge)
+                : m_view(view), m_first(first), m_position(position), m_last(last),
+                  m_firstEdge(firstEdge) {
+                skipHidden();
+            }
+            void skipHidden() {
+                while (m_position != m_last && !m_view->contains(*m_position)) {
+                    ++m_position;
+                }
+            }
+
+            const CFGGraphView* m_view;
+            const uint32_t* m_first;
+            const uint32_t* m_position;
+            const uint32_t* m_last;
+            uint32_t m_firstEdge;
+        };
+
+        class SuccessorRange {
+        public:
+            SuccessorIterator begin() const { return m_begin; }
+            SuccessorIterator end() const { return m_end; }
+            bool empty() const { return m_begin == m_end; }
+
+        private:
+            friend class CFGGraphView;
+            SuccessorRange(SuccessorIterator begin, SuccessorIterator end) : m_begin(begin), m_end(end) {}
+
+            SuccessorIterator m_begin;
+            SuccessorIterator m_end;
+        };
+
+    private:
+        // Switches from the implicit all-nodes state to an explicit bitmap.
+        void materialize();
+        // Index of the first node in the view after index, or -1.
+        int next(int index) const;
+        // Recomputes m_foldedInto from m_collapsed and m_collapsedComponents.
+        void refold();
+
+        std::shared_ptr<const FrozenGraph> m_graph;
+        // Unused while m_complete; otherwise one bit per graph node.
+        llvm::BitVector m_visible;
+        bool m_complete = true;
+        // One bit per region; empty until a region is collapsed.
+        llvm::BitVector m_collapsed;
+        // One bit per component; empty until a component is collapsed.
+        llvm::BitVector m_collapsedComponents;
+        // Per node; empty while nothing is folded.
+        std::vector<uint32_t> m_foldedInto;
+    };
+
+} // namespace GraphGenerator
+
+#endif // GRAPH_VIEW_H
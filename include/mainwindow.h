@@ -2,7 +2,6 @@
 #define MAINWINDOW_H
 
 #include "cfg_analyzer.h"
-#include "node.h"
 #include <QMainWindow>
 #include <QProgressDialog>
 #include <QFileInfo>
@@ -10,8 +9,10 @@
 #include <QTextStream>
 #include <QSettings>
 #include <QFileSystemWatcher>
+#include <QTimer>
 #include <QSettings>
 #include <QThread>
+#include <QThreadPool>
 #include <QSet>
 #include <QListWidgetItem>
 #include <string>
@@ -26,9 +27,12 @@
 #include "cfg_analyzer.h"
 #include "customgraphview.h"
 #include "graph_generator.h"
+#include "graph_analysis.h"
+#include "graph_view.h"
 #include "parser.h"
 #include "ui_mainwindow.h"
 #include "ast_extractor.h"
+#include "CFGBridge.h"
 
 namespace Ui {
 class MainWindow;
@@ -148,8 +152,11 @@ public:
     void startTextOnlyMode();
     bool tryInitializeView(bool tryHardware);
     bool testRendering();
-    void visualizeCFG(std::shared_ptr<GraphGenerator::CFGGraph> graph);
-    QString generateInteractiveDot(std::shared_ptr<GraphGenerator::CFGGraph> graph);
+    // What m_currentGraph holds; picks the view it is drawn through.
+    enum class GraphKind { ControlFlow, CallGraph };
+    void visualizeCFG(std::shared_ptr<const GraphGenerator::FrozenGraph> graph,
+                      GraphKind kind = GraphKind::ControlFlow);
+    QString generateInteractiveDot(const GraphGenerator::CFGGraphView& graph);
     QString generateProgressiveDot(const QString& fullDot, int rootNode);
     void handleProgressiveNodeClick(const QString& nodeId);
     void displayProgressiveGraph();
@@ -161,12 +168,17 @@ public:
     void initialize();
     void openFile(const QString& filePath);
     std::unordered_map<int, bool> m_expandedNodes;  // Tracks expanded nodes
-    std::unordered_map<int, bool> m_visibleNodes;  // Tracks visible nodes
+    GraphGenerator::CFGGraphView m_visibleNodes;    // Revealed part of m_currentGraph
+    GraphGenerator::CFGGraphView m_regionView;      // m_currentGraph with regions folded
+    QSet<int> m_expandedRegions;                    // Entry ids of regions the user opened
+    GraphGenerator::CFGGraphView m_callGraphView;   // Call graph with recursion cycles folded
+    QSet<int> m_expandedComponents;                 // Lowest member ids of cycles the user opened
+    GraphKind m_graphKind = GraphKind::ControlFlow; // Kind of m_currentGraph
     int m_currentRootNode = -1;                     // Current root node ID
     QMutex m_graphMutex;  
 
 public slots:
-    void handleVisualizationResult(std::shared_ptr<GraphGenerator::CFGGraph> graph);
+    void handleVisualizationResult(std::shared_ptr<const GraphGenerator::FrozenGraph> graph);
     void handleVisualizationError(const QString& error);
 
     void onNodeExpanded(const QString& nodeId);
@@ -243,6 +255,8 @@ private slots:
     void showNextSearchResult();
     void showPreviousSearchResult();
     void onAddFileClicked();
+    void onAnalyzeProjectClicked();
+    void showFunctionMetrics();
     void onRemoveFileClicked();
     void onClearFilesClicked();
 
@@ -263,8 +277,7 @@ private:
     QSet<QString> m_functionNames;
 
     // Graph Data
-    std::shared_ptr<GraphGenerator::CFGGraph> m_currentGraph;
-    std::shared_ptr<GraphGenerator::CFGNode> findNodeById(const QString& nodeId) const;
+    std::shared_ptr<const GraphGenerator::FrozenGraph> m_currentGraph;
     
     // Other members
     QThread* m_analysisThread;
@@ -272,6 +285,17 @@ private:
     VisualizationTheme m_currentTheme;
     QGraphicsItem* m_highlightNode;
     QGraphicsItem* m_highlightEdge;
+    // Nodes controlled by the highlighted branch
+    QList<QGraphicsItem*> m_controlledNodes;
+    // Paths shown by showHighlightedPaths(), laid out as Visualizer's
+    // highlightPaths, and the scene items drawn for them
+    std::vector<int> m_highlightedPaths;
+    QList<QGraphicsItem*> m_pathItems;
+    // Last clicked edge, for Highlight Path; -1 when none
+    QPair<int, int> m_selectedEdge{-1, -1};
+    static constexpr size_t MaxHighlightedPaths = 8;
+    // Edge visits one path search may spend before it gives up
+    static constexpr size_t PathSearchSteps = 1 << 18;
     Parser m_parser;
     ASTExtractor m_astExtractor;
 
@@ -290,8 +314,18 @@ private:
     int m_currentlySelectedNodeId = -1;
 
     CFGAnalyzer::CFGAnalyzer m_analyzer;
-
-    std::string generateValidDot(std::shared_ptr<GraphGenerator::CFGGraph> graph);
+    // Held around every use of m_analyzer: its sessions and snapshots are
+    // not meant to be driven from two threads at once.
+    QMutex m_analyzerMutex;
+    // Background jobs on m_analyzer, run one at a time and drained before
+    // the window goes away.
+    QThreadPool m_analyzerJobs;
+    // Metrics of the last analysis, for the Function Metrics dialog
+    CFGAnalyzer::MetricsTable m_metrics;
+    QAction* m_outOfProcessAction = nullptr;
+    CFGBridge* m_bridge = nullptr;
+
+    std::string generateValidDot(const GraphGenerator::CFGGraphView& graph);
     QString escapeDotLabel(const QString& input);
     void createNode();
     void createEdge();
@@ -305,6 +339,15 @@ private:
     QString generateInteractiveGraphHtml(const QString& dotContent) const;
     void highlightEdge(int fromId, int toId, const QColor& color);  
     void resetHighlighting();
+    // Entry or exit node reachable from start against or along the edges
+    uint32_t pathEnd(uint32_t start, bool forward) const;
+    GraphGenerator::PathEnumerator::Options pathOptions(size_t maxPaths) const;
+    QString describePath(const GraphGenerator::PathEnumerator::Path& path) const;
+    // Shortest paths from fromId to toId; -1 stands for the entry or exit
+    bool highlightPaths(int fromId, int toId, size_t maxPaths);
+    // Shortest entry-to-exit path through the edge fromId -> toId
+    bool highlightPathThrough(int fromId, int toId);
+    void showHighlightedPaths(std::vector<int> paths, const QStringList& descriptions);
 
     QAction* m_nextSearchAction;
     QAction* m_prevSearchAction;
@@ -341,6 +384,18 @@ private:
     void updateEdgeWeights();
     Q_INVOKABLE void expandNode(const QString& nodeIdStr);
     void collapseNode(int nodeId);
+    // m_currentGraph with every region collapsed except those the user
+    // expanded; rebound whenever m_currentGraph changes.
+    const GraphGenerator::CFGGraphView& regionView();
+    // Folds or unfolds the region entered at nodeId and redraws; false when
+    // no region starts there or it already is in that state.
+    bool setRegionCollapsed(int nodeId, bool collapsed);
+    // Call graph condensation: m_currentGraph with every recursive SCC
+    // folded into its first function, except those the user expanded.
+    const GraphGenerator::CFGGraphView& callGraphView();
+    bool setComponentCollapsed(int nodeId, bool collapsed);
+    // regionView() for a CFG, callGraphView() for a call graph.
+    const GraphGenerator::CFGGraphView& currentView();
 
     QString parseNodeAttributes(const QString& attributes);
     void clearVisualization();
@@ -352,7 +407,7 @@ private:
     void saveNodeInformation(const QString& filePath);
     void loadNodeInformation(const QString& filePath);
 
-    void displayNodeDetails(int nodeId, const GraphGenerator::CFGNode& node);
+    void displayNodeDetails(int nodeId);
     void highlightNodeInCodeEditor(int nodeId);
     void clearCodeHighlights();
 
@@ -363,11 +418,16 @@ private:
     void highlightFunction(const QString& functionName);
     void visualizeFunction(const QString& functionName);
     void resetViewZoom();
-    std::shared_ptr<GraphGenerator::CFGGraph> generateFunctionCFG(const QString& filePath, const QString& functionName);
+    std::shared_ptr<const GraphGenerator::FrozenGraph> generateFunctionCFG(const QString& filePath, const QString& functionName);
     void setUiEnabled(bool enabled);
-    std::shared_ptr<GraphGenerator::CFGGraph> parseDotToCFG(const QString& dotContent);
+    std::shared_ptr<const GraphGenerator::FrozenGraph> parseDotToCFG(const QString& dotContent);
 
     bool m_webChannelReady = false;
+
+    // Debounced live CFG refresh from the editor buffer
+    QTimer* m_liveRefreshTimer = nullptr;
+    bool m_liveRefreshRunning = false;
+    bool m_liveRefreshPending = false;
     
     QString m_pendingDotContent;
     bool m_pendingProgressive = false;
@@ -378,7 +438,8 @@ private:
     QList<QThread*> m_workerThreads;
 
     void analyzeSingleFile(const QString& filePath);
-    std::string filterDotOutput(const std::string& dotOutput);
+    void reanalyzeChangedFunctions(const QString& filePath);
+    void refreshFunctionUnderCursor();
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
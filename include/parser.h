@@ -5,6 +5,8 @@
 #include <clang/AST/ASTContext.h>
 #include <clang/Basic/Diagnostic.h>
 #include <clang/AST/ASTConsumer.h>
+#include "frozen_graph.h"
+#include "string_pool.h"
 #include <memory>
 #include <vector>
 #include <string>
@@ -15,7 +17,6 @@ namespace clang {
     class CompilerInstance;
     class ASTConsumer;
     class FunctionDecl;
-    class CFG;
 }
 
 class Parser {
@@ -23,23 +24,11 @@ public:
     // Forward declare ASTStoringConsumer first
     class ASTStoringConsumer;
     
-    struct CFGNode {
-        unsigned id;
-        std::string label;
-        unsigned line;
-        std::string code;
-    };
-
-    struct CFGEdge {
-        unsigned sourceId;
-        unsigned targetId;
-        std::string label;
-    };
-
+    // Built by GraphGenerator::generateCFG, so it is the same graph the
+    // analyzer and the GUI use; node ids are Clang CFG block ids.
     struct FunctionCFG {
         std::string functionName;
-        std::vector<CFGNode> nodes;
-        std::vector<CFGEdge> edges;
+        std::shared_ptr<const GraphGenerator::FrozenGraph> graph;
     };
 
     struct FunctionInfo {
@@ -67,13 +56,12 @@ public:
     std::vector<FunctionInfo> extractFunctions(const std::string& filePath);
     std::vector<FunctionCFG> extractAllCFGs(const std::string& filePath);
     std::string generateDOT(const FunctionCFG& cfg);
-    
-    // Add these helper function declarations
-    static void processCFGBlocks(const clang::CFG& cfg, FunctionCFG& functionCFG, clang::ASTContext* context);
-    static void processCFGEdges(const clang::CFG& cfg, FunctionCFG& functionCFG);
+
 
 private:
     struct FunctionVisitor;
+    // Statement text of every CFG this parser extracted.
+    std::shared_ptr<GraphGenerator::StringPool> m_strings;
     static clang::ASTContext* parseFile(const std::string& filename);
 };
 
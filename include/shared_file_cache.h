@@ -0,0 +1,94 @@
+#ifndef SHARED_FILE_CACHE_H
+#define SHARED_FILE_CACHE_H
+
+#include <llvm/ADT/IntrusiveRefCntPtr.h>
+#include <llvm/Support/ErrorOr.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/VirtualFileSystem.h>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace CFGAnalyzer {
+
+    class CachingFileSystem;
+
+    // Process-wide cache of stat results and file contents shared by every
+    // translation unit parsed in this process (ClangTool runs, session ASTs
+    // and Parser). Negative lookups are cached too, since most stats during
+    // include search are misses. Entries are keyed by absolute path and stay
+    // valid until invalidated, so callers must invalidate paths they know
+    // changed, or clear() before a run that should see the disk afresh.
+    // Contents are capped at maxBytes(), oldest first out, and the stat
+    // table at MaxStatuses entries, so long batch processes stay bounded.
+    class SharedFileCache {
+    public:
+        struct Stats {
+            uint64_t statHits = 0;
+            uint64_t statMisses = 0;
+            uint64_t readHits = 0;
+            uint64_t readMisses = 0;
+            uint64_t evictions = 0;
+        };
+
+        static constexpr size_t MaxStatuses = 1 << 20;
+
+        static SharedFileCache& instance();
+
+        // Each filesystem has its own working directory (ClangTool changes it
+        // per compile command) but answers from the shared cache.
+        llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> createFileSystem();
+
+        void invalidate(const std::string& path);
+        void clear();
+        Stats stats() const;
+
+        uint64_t maxBytes() const { return m_maxBytes.load(); }
+        void setMaxBytes(uint64_t maxBytes);
+
+        // Contents currently cached for path, or null. Does not read the file
+        // or count towards the stats; holding the buffer keeps it alive past
+        // invalidation.
+        std::shared_ptr<const llvm::MemoryBuffer> cachedBuffer(const std::string& path) const;
+
+    private:
+        friend class CachingFileSystem;
+
+        struct Contents {
+            llvm::vfs::Status status;
+            std::shared_ptr<llvm::MemoryBuffer> buffer;
+        };
+
+        SharedFileCache() = default;
+
+        bool findStatus(const std::string& path, llvm::ErrorOr<llvm::vfs::Status>& status);
+        void storeStatus(const std::string& path, const llvm::ErrorOr<llvm::vfs::Status>& status);
+        std::shared_ptr<const Contents> findContents(const std::string& path);
+        std::shared_ptr<const Contents> storeContents(const std::string& path,
+                                                      const llvm::vfs::Status& status,
+                                                      std::unique_ptr<llvm::MemoryBuffer> buffer);
+        // Drops the oldest contents until they fit maxBytes(); m_mutex held.
+        void evictContents();
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, llvm::ErrorOr<llvm::vfs::Status>> m_statuses;
+        std::unordered_map<std::string, std::shared_ptr<const Contents>> m_contents;
+        // Keys of m_contents in insertion order; may name erased entries.
+        std::deque<std::string> m_contentOrder;
+        uint64_t m_contentBytes = 0;
+        std::atomic<uint64_t> m_maxBytes{512ull * 1024 * 1024};
+
+        std::atomic<uint64_t> m_statHits{0};
+        std::atomic<uint64_t> m_statMisses{0};
+        std::atomic<uint64_t> m_readHits{0};
+        std::atomic<uint64_t> m_readMisses{0};
+        std::atomic<uint64_t> m_evictions{0};
+    };
+
+} // namespace CFGAnalyzer
+
+#endif // SHARED_FILE_CACHE_H
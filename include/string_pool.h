@@ -0,0 +1,126 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/Allocator.h>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace GraphGenerator {
+
+    // Text of one source file exactly as it was parsed. Statement labels are
+    // slices of it, so it has to outlive every graph built from the parse.
+    class SourceFile {
+    public:
+        SourceFile(std::string path, llvm::StringRef text, std::shared_ptr<const void> owner)
+            : m_path(std::move(path)), m_text(text), m_owner(std::move(owner)) {}
+
+        const std::string& path() const { return m_path; }
+        llvm::StringRef text() const { return m_text; }
+
+    private:
+        std::string m_path;
+        llvm::StringRef m_text;
+        // Keeps m_text alive when it is borrowed rather than copied.
+        std::shared_ptr<const void> m_owner;
+    };
+
+    // Interning table for statement text. Each distinct string is stored once
+    // in a bump arena and handed out as a pointer-sized Ref that stays valid
+    // as long as the pool does; graphs keep their pool alive through a
+    // shared_ptr. Text is stored raw and escaped by whoever emits it.
+    // The pool also holds the SourceFiles that StatementText slices point
+    // into. intern() and addSource() may be called from several analysis
+    // threads at once.
+    class StringPool {
+        using Entry = llvm::StringMapEntry<std::nullopt_t>;
+
+    public:
+        class Ref {
+        public:
+            Ref() = default;
+
+            llvm::StringRef str() const { return m_entry ? m_entry->getKey() : llvm::StringRef(); }
+            QString toQString() const {
+                llvm::StringRef text = str();
+                return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+            }
+            bool empty() const { return str().empty(); }
+
+            // Refs from one pool are equal exactly when their text is.
+            bool operator==(Ref other) const { return m_entry == other.m_entry; }
+            bool operator!=(Ref other) const { return m_entry != other.m_entry; }
+
+        private:
+            friend class StringPool;
+            explicit Ref(const Entry* entry) : m_entry(entry) {}
+
+            const Entry* m_entry = nullptr;
+        };
+
+        StringPool() = default;
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+
+        Ref intern(llvm::StringRef text);
+        Ref intern(const QString& text);
+
+        // Registers the parsed text of path. With an owner the text is
+        // borrowed and owner keeps it alive; without one it is copied into
+        // the arena. Re-adding identical text returns the existing file.
+        const SourceFile* addSource(const std::string& path, llvm::StringRef text,
+                                    std::shared_ptr<const void> owner = nullptr);
+
+        size_t size() const;
+        // Arena bytes plus borrowed source text the pool keeps alive.
+        size_t bytesAllocated() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        llvm::StringSet<llvm::BumpPtrAllocator> m_strings;
+        std::vector<std::unique_ptr<SourceFile>> m_sources;
+        llvm::StringMap<const SourceFile*> m_latestSource;
+        size_t m_borrowedBytes = 0;
+    };
+
+    // Text of one CFG statement: either a [begin, end) byte range of the
+    // parsed source, produced only when someone reads it, or an interned
+    // pretty-printed string for statements that have no contiguous spelling
+    // (macro expansions, implicit code).
+    class StatementText {
+    public:
+        StatementText() = default;
+        StatementText(StringPool::Ref text) : m_text(text) {}
+        StatementText(const SourceFile* file, uint32_t begin, uint32_t end)
+            : m_file(file), m_begin(begin), m_end(end) {}
+
+        llvm::StringRef str() const {
+            return m_file ? m_file->text().slice(m_begin, m_end) : m_text.str();
+        }
+        QString toQString() const {
+            llvm::StringRef text = str();
+            return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+        }
+        bool empty() const { return str().empty(); }
+
+        // Source slice, or null for pretty-printed text.
+        const SourceFile* sourceFile() const { return m_file; }
+        uint32_t beginOffset() const { return m_begin; }
+        uint32_t endOffset() const { return m_end; }
+
+    private:
+        StringPool::Ref m_text;
+        const SourceFile* m_file = nullptr;
+        uint32_t m_begin = 0;
+        uint32_t m_end = 0;
+    };
+
+} // namespace GraphGenerator
+
+#endif // STRING_POOL_H
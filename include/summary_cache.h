@@ -0,0 +1,71 @@
+#ifndef SUMMARY_CACHE_H
+#define SUMMARY_CACHE_H
+
+#include "cfg_analyzer.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CFGAnalyzer {
+
+    // Persistent, content-addressed cache of per-TU analysis summaries.
+    //
+    // Entries are found through a manifest key (compile flags + main file
+    // path + main file contents). Each entry records every file the TU read
+    // while parsing with its size, mtime and content hash; a lookup is a hit
+    // only if all of them still match. Stat data is checked first so that
+    // unchanged headers are not re-hashed. Total size is capped and the
+    // least recently used entries are evicted first.
+    class SummaryCache {
+    public:
+        struct Stats {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+        };
+
+        SummaryCache(const std::string& directory, uint64_t maxBytes);
+
+        bool lookup(const std::string& mainFile, const std::string& flags,
+                    AnalysisResult& result);
+        void store(const std::string& mainFile, const std::string& flags,
+                   const std::vector<std::string>& dependencies,
+                   const AnalysisResult& result);
+
+        Stats stats() const;
+        const std::string& directory() const { return m_directory; }
+        uint64_t maxBytes() const { return m_maxBytes; }
+
+    private:
+        struct IndexEntry {
+            uint64_t size = 0;
+            std::filesystem::file_time_type lastUse;
+        };
+
+        static std::string hashString(const std::string& data);
+        static bool hashFile(const std::string& path, std::string& hash);
+        std::string manifestKey(const std::string& mainFile, const std::string& flags) const;
+        std::filesystem::path entryPath(const std::string& key) const;
+        void loadIndex();
+        void touch(const std::filesystem::path& path);
+        void evictIfNeeded();
+
+        std::string m_directory;
+        uint64_t m_maxBytes;
+
+        std::mutex m_indexMutex;
+        std::map<std::string, IndexEntry> m_index;
+        uint64_t m_totalBytes = 0;
+
+        std::atomic<uint64_t> m_hits{0};
+        std::atomic<uint64_t> m_misses{0};
+        std::atomic<uint64_t> m_evictions{0};
+    };
+
+} // namespace CFGAnalyzer
+
+#endif // SUMMARY_CACHE_H
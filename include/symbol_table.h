@@ -0,0 +1,92 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <llvm/ADT/StringMap.h>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace clang {
+    class FunctionDecl;
+}
+
+namespace CFGAnalyzer {
+
+    // Dense process-local id of a function, keyed by its clang USR. Ids are
+    // handed out in first-seen order, so they differ between runs and
+    // processes; anything written to disk or a pipe stores the USR instead.
+    using SymbolId = uint32_t;
+
+    // Call edges: caller -> callees, sorted and free of duplicates.
+    using CallGraph = std::unordered_map<SymbolId, std::vector<SymbolId>>;
+
+    struct Symbol {
+        std::string usr;
+        // Qualified name; overloads share it.
+        std::string name;
+        // Parameter list such as "(int, const char *)", used to tell
+        // overloads apart when they are printed.
+        std::string parameters;
+    };
+
+    // Process-wide USR -> SymbolId table shared by every analysis thread.
+    // Symbols are never removed, and the references symbol() returns stay
+    // valid for the life of the process.
+    class SymbolTable {
+    public:
+        static SymbolTable& instance();
+
+        // Returns the id of usr, registering it on first sight.
+        SymbolId intern(const std::string& usr, const std::string& name,
+                        const std::string& parameters = std::string());
+        SymbolId intern(const clang::FunctionDecl* function);
+
+        const Symbol& symbol(SymbolId id) const;
+        size_t size() const;
+
+    private:
+        SymbolTable() = default;
+
+        mutable std::mutex m_mutex;
+        llvm::StringMap<SymbolId> m_ids;
+        // deque so references survive growth.
+        std::deque<Symbol> m_symbols;
+    };
+
+    // Presentation names for the symbols of one call graph: the qualified
+    // name, with the parameter list appended when several symbols in the
+    // graph share that name. Ordering helpers sort by these names (USR as
+    // tie-break) so printed output does not depend on id assignment.
+    class SymbolNames {
+    public:
+        explicit SymbolNames(const CallGraph& calls);
+
+        const std::string& operator[](SymbolId id) const;
+        bool contains(SymbolId id) const { return m_names.count(id) != 0; }
+
+        // Every caller and callee of the graph.
+        const std::vector<SymbolId>& symbols() const { return m_sorted; }
+        std::vector<const CallGraph::value_type*> sortedCallers() const;
+        std::vector<SymbolId> sorted(const std::vector<SymbolId>& ids) const;
+
+    private:
+        bool less(SymbolId a, SymbolId b) const;
+
+        const CallGraph& m_calls;
+        std::unordered_map<SymbolId, std::string> m_names;
+        std::vector<SymbolId> m_sorted;
+    };
+
+    // Sorts callees and drops duplicates; analyses append while they walk
+    // the AST and normalize once at the end.
+    void normalizeCallGraph(CallGraph& calls);
+    // Adds source's edges to target; both must be normalized, and target
+    // stays so.
+    void mergeCallGraph(CallGraph& target, CallGraph&& source);
+
+} // namespace CFGAnalyzer
+
+#endif // SYMBOL_TABLE_H
@@ -4,6 +4,7 @@
 #include <QGraphicsScene>
 #include <string>
 #include "graph_generator.h"
+#include "graph_analysis.h"
 
 namespace Visualizer {
 
@@ -25,9 +26,18 @@ bool isGraphvizAvailable();
 bool renderDotFile(QGraphicsScene* scene, const QString& dotFilePath);
 bool exportToFile(const QString& dotFilePath, const QString& outputPath, ExportFormat format);
 
+// highlightPaths lists the node ids of each path in order, with
+// PathSeparator between paths; consecutive ids mark the edges to draw bold.
+constexpr int PathSeparator = -1;
+
+// Appends one enumerated path of graph in that layout.
+void appendPath(std::vector<int>& highlightPaths,
+                const GraphGenerator::FrozenGraph& graph,
+                const GraphGenerator::PathEnumerator::Path& path);
+
 // DOT generation
 std::string generateDotRepresentation(
-    const GraphGenerator::CFGGraph* graph,
+    const GraphGenerator::FrozenGraph* graph,
     bool showLineNumbers = true,
     bool simplifyGraph = false,
     const std::vector<int>& highlightPaths = {});
@@ -36,12 +46,12 @@ std::string generateDotRepresentation(
 bool analyzeAndVisualizeCppFile(const QString& cppFilePath, QGraphicsScene* scene);
 
 std::string generateDotWithAnimation(
-    const GraphGenerator::CFGGraph* graph, 
+    const GraphGenerator::FrozenGraph* graph, 
     AnimationType anim,
     const std::vector<int>& animatedNodes);
 
 bool exportToDot(
-    const GraphGenerator::CFGGraph* graph,
+    const GraphGenerator::FrozenGraph* graph,
     const std::string& filename,
     bool showLineNumbers = true,
     bool simplifyGraph = false,
@@ -49,7 +59,7 @@ bool exportToDot(
 );
 
 bool exportGraph(
-    const GraphGenerator::CFGGraph* graph,
+    const GraphGenerator::FrozenGraph* graph,
     const std::string& filename,
     ExportFormat format = ExportFormat::DOT,
     bool showLineNumbers = true,
@@ -0,0 +1,33 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace CFGAnalyzer {
+
+    // Fixed-size pool of std::threads that drains an index range. Indices are
+    // handed out in ascending order from a shared atomic counter, so a slow
+    // translation unit never blocks the rest of the queue.
+    class WorkerPool {
+    public:
+        explicit WorkerPool(unsigned jobs = 0);
+
+        unsigned jobs() const { return m_jobs; }
+        static unsigned defaultJobs();
+
+        // Runs task(i) for every i in [0, count). onComplete(i) is invoked
+        // after each task, serialized across workers; returning false cancels
+        // every index not yet started. Returns false if the run was canceled.
+        // The first exception thrown by a task is rethrown on the calling
+        // thread once all workers joined.
+        bool run(size_t count, const std::function<void(size_t)>& task,
+                 const std::function<bool(size_t)>& onComplete = nullptr);
+
+    private:
+        unsigned m_jobs;
+    };
+
+} // namespace CFGAnalyzer
+
+#endif // WORKER_POOL_H
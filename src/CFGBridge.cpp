@@ -0,0 +1,435 @@
+#include "CFGBridge.h"
+#include "analysis_codec.h"
+#include "worker_pool.h"
+#include <clang/Tooling/CompilationDatabase.h>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QEventLoop>
+#include <QTextStream>
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <map>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+
+// Frames are a big-endian quint32 length followed by a QDataStream payload.
+QByteArray frame(const QByteArray& payload) {
+    QByteArray data(4, '\0');
+    qToBigEndian<quint32>(static_cast<quint32>(payload.size()), data.data());
+    return data + payload;
+}
+
+bool takeFrame(QByteArray& buffer, QByteArray& payload) {
+    if (buffer.size() < 4) {
+        return false;
+    }
+    quint32 size = qFromBigEndian<quint32>(buffer.constData());
+    if (static_cast<quint32>(buffer.size()) - 4 < size) {
+        return false;
+    }
+    payload = buffer.mid(4, size);
+    buffer.remove(0, 4 + size);
+    return true;
+}
+
+bool readFully(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t count = ::read(fd, data, size);
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+bool writeFully(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t count = ::write(fd, data, size);
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+qint64 peakRssKb() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_maxrss;
+}
+
+} // namespace
+
+CFGBridge::CFGBridge(QObject* parent)
+    : CFGBridge(Options(), parent)
+{
+}
+
+CFGBridge::CFGBridge(const Options& options, QObject* parent)
+    : QObject(parent), m_options(options)
+{
+    if (m_options.workers <= 0) {
+        m_options.workers = static_cast<int>(CFGAnalyzer::WorkerPool::defaultJobs());
+    }
+}
+
+CFGBridge::~CFGBridge() {
+    for (auto& worker : m_workers) {
+        worker->process->disconnect(this);
+        worker->process->closeWriteChannel();
+        if (!worker->process->waitForFinished(2000)) {
+            worker->process->kill();
+            worker->process->waitForFinished(1000);
+        }
+    }
+}
+
+int CFGBridge::runWorker() {
+    // The protocol owns the original stdout; anything else that prints to
+    // stdout (Clang, llvm::outs) is sent to stderr instead.
+    int protocolFd = ::dup(STDOUT_FILENO);
+    ::dup2(STDERR_FILENO, STDOUT_FILENO);
+
+    // Workers only report results; any files are written by the parent.
+    CFGAnalyzer::CFGAnalyzer analyzer;
+    CFGAnalyzer::AnalysisOptions options = analyzer.options();
+    options.emitFunctionDots = false;
+    analyzer.setOptions(options);
+    auto defaults = CFGAnalyzer::CFGAnalyzer::defaultCompilations();
+    std::map<QString, std::unique_ptr<clang::tooling::CompilationDatabase>> databases;
+
+    while (true) {
+        char header[4];
+        if (!readFully(STDIN_FILENO, header, sizeof(header))) {
+            break;
+        }
+        QByteArray request(qFromBigEndian<quint32>(header), '\0');
+        if (!readFully(STDIN_FILENO, request.data(), request.size())) {
+            break;
+        }
+
+        qint32 index = 0;
+        QString filePath;
+        QString buildPath;
+        QDataStream in(request);
+        in >> index >> filePath >> buildPath;
+
+        CFGAnalyzer::AnalysisResult result;
+        const clang::tooling::CompilationDatabase* compilations = defaults.get();
+        if (!buildPath.isEmpty()) {
+            auto& database = databases[buildPath];
+            std::string errorMessage;
+            if (!database) {
+                database = CFGAnalyzer::CFGAnalyzer::loadCompilations(buildPath.toStdString(), errorMessage);
+            }
+            compilations = database.get();
+            if (!compilations) {
+                result.report = "Failed to load compilation database: " + errorMessage;
+            }
+        }
+        if (compilations) {
+            result = analyzer.analyzeWithDatabase(*compilations, filePath.toStdString());
+        }
+
+        QByteArray response;
+        QDataStream out(&response, QIODevice::WriteOnly);
+        out << index << peakRssKb() << CFGAnalyzer::AnalysisCodec::encode(result);
+        QByteArray data = frame(response);
+        if (!writeFully(protocolFd, data.constData(), data.size())) {
+            break;
+        }
+    }
+
+    ::close(protocolFd);
+    return 0;
+}
+
+CFGAnalyzer::AnalysisResult CFGBridge::analyzeFileSync(const QString& filePath) {
+    if (m_batchActive) {
+        return CFGAnalyzer::AnalysisResult(false, "", "An out-of-process analysis is already running");
+    }
+
+    bool done = false;
+    QEventLoop loop;
+    auto connection = connect(this, &CFGBridge::analysisComplete, &loop,
+                              [&](const CFGAnalyzer::AnalysisResult&) {
+        done = true;
+        loop.quit();
+    });
+    analyzeFile(filePath);
+    if (!done) {
+        loop.exec();
+    }
+    disconnect(connection);
+
+    return takeResult();
+}
+
+void CFGBridge::analyzeFile(const QString& filePath) {
+    startBatch(QStringList{filePath}, QString());
+}
+
+void CFGBridge::analyzeFiles(const QStringList& filePaths, const QString& buildPath) {
+    startBatch(filePaths, buildPath);
+}
+
+void CFGBridge::analyzeProject(const QString& buildPath) {
+    std::string errorMessage;
+    auto compilations = CFGAnalyzer::CFGAnalyzer::loadCompilations(buildPath.toStdString(), errorMessage);
+    if (!compilations) {
+        QString message = QString("Failed to load compilation database: %1")
+                              .arg(QString::fromStdString(errorMessage));
+        emit errorOccurred(message);
+        m_result = CFGAnalyzer::AnalysisResult(false, "", message.toStdString());
+        emit analysisComplete(m_result);
+        return;
+    }
+
+    std::vector<std::string> files = compilations->getAllFiles();
+    std::sort(files.begin(), files.end());
+
+    QStringList filePaths;
+    for (const auto& file : files) {
+        filePaths << QString::fromStdString(file);
+    }
+    startBatch(filePaths, buildPath);
+}
+
+void CFGBridge::startBatch(const QStringList& filePaths, const QString& buildPath) {
+    if (m_batchActive) {
+        emit errorOccurred("An out-of-process analysis is already running");
+        return;
+    }
+    if (filePaths.isEmpty()) {
+        m_result = CFGAnalyzer::AnalysisResult(false, "", "No files to analyze");
+        emit analysisComplete(m_result);
+        return;
+    }
+
+    m_batchActive = true;
+    m_buildPath = buildPath;
+    m_jobs.clear();
+    m_queue.clear();
+    m_partials.clear();
+    m_partials.resize(filePaths.size());
+    m_completed = 0;
+    m_retried = 0;
+    m_crashes = 0;
+    m_recycles = 0;
+    m_timer.start();
+
+    for (int i = 0; i < filePaths.size(); ++i) {
+        Job job;
+        job.index = i;
+        job.filePath = filePaths[i];
+        m_jobs.push_back(job);
+        m_queue.enqueue(i);
+    }
+
+    emit progress(0, static_cast<int>(m_jobs.size()));
+    dispatch();
+}
+
+void CFGBridge::dispatch() {
+    for (auto& worker : m_workers) {
+        if (m_queue.isEmpty()) return;
+        if (worker->jobIndex < 0 && !worker->retiring &&
+            worker->process->state() == QProcess::Running) {
+            sendJob(worker.get(), m_queue.dequeue());
+        }
+    }
+
+    while (!m_queue.isEmpty() && static_cast<int>(m_workers.size()) < m_options.workers) {
+        Worker* worker = startWorker();
+        if (!worker) break;
+        sendJob(worker, m_queue.dequeue());
+    }
+
+    // Nothing is running and nothing can be started: fail what is left
+    // rather than wait forever.
+    if (m_workers.empty() && !m_queue.isEmpty()) {
+        emit errorOccurred("Failed to start analysis worker process");
+        while (!m_queue.isEmpty()) {
+            int index = m_queue.dequeue();
+            CFGAnalyzer::AnalysisResult failed;
+            failed.report = "Failed to start analysis worker process";
+            completeJob(index, std::move(failed));
+        }
+    }
+}
+
+CFGBridge::Worker* CFGBridge::startWorker() {
+    auto worker = std::make_unique<Worker>();
+    Worker* raw = worker.get();
+    raw->process = new QProcess(this);
+    raw->process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+    connect(raw->process, &QProcess::readyReadStandardOutput,
+            this, [this, raw]() { onWorkerOutput(raw); });
+    connect(raw->process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, [this, raw](int exitCode, QProcess::ExitStatus exitStatus) {
+                onWorkerFinished(raw, exitCode, exitStatus);
+            });
+
+    raw->process->start(QCoreApplication::applicationFilePath(), {"--analysis-worker"});
+    if (!raw->process->waitForStarted(5000)) {
+        qCritical() << "Failed to start analysis worker:" << raw->process->errorString();
+        raw->process->disconnect(this);
+        raw->process->deleteLater();
+        return nullptr;
+    }
+
+    m_workers.push_back(std::move(worker));
+    return raw;
+}
+
+void CFGBridge::sendJob(Worker* worker, int index) {
+    Job& job = m_jobs[index];
+    ++job.attempts;
+    worker->jobIndex = index;
+
+    QByteArray request;
+    QDataStream out(&request, QIODevice::WriteOnly);
+    out << qint32(index) << job.filePath << m_buildPath;
+    worker->process->write(frame(request));
+}
+
+void CFGBridge::onWorkerOutput(Worker* worker) {
+    worker->buffer += worker->process->readAllStandardOutput();
+
+    QByteArray payload;
+    while (takeFrame(worker->buffer, payload)) {
+        qint32 index = -1;
+        qint64 workerRssKb = 0;
+        QByteArray encoded;
+        QDataStream in(payload);
+        in >> index >> workerRssKb >> encoded;
+
+        if (index != worker->jobIndex) {
+            qWarning() << "Analysis worker answered job" << index << "while running" << worker->jobIndex;
+            continue;
+        }
+
+        CFGAnalyzer::AnalysisResult result;
+        if (!CFGAnalyzer::AnalysisCodec::decode(encoded, result)) {
+            result = CFGAnalyzer::AnalysisResult();
+            result.report = "Malformed result from analysis worker";
+        }
+
+        worker->jobIndex = -1;
+        ++worker->jobsDone;
+        if (worker->jobsDone >= m_options.maxJobsPerWorker ||
+            workerRssKb > m_options.maxWorkerMemoryKb) {
+            // EOF on stdin ends the worker; a fresh one takes its place.
+            worker->retiring = true;
+            worker->process->closeWriteChannel();
+        }
+
+        completeJob(index, std::move(result));
+    }
+
+    if (m_batchActive) {
+        dispatch();
+    }
+}
+
+void CFGBridge::onWorkerFinished(Worker* worker, int exitCode, QProcess::ExitStatus exitStatus) {
+    int index = worker->jobIndex;
+    bool recycled = worker->retiring;
+    removeWorker(worker);
+
+    if (!recycled) {
+        qWarning() << "Analysis worker exited unexpectedly, code" << exitCode
+                   << (exitStatus == QProcess::CrashExit ? "(crashed)" : "");
+    }
+    if (m_batchActive) {
+        ++(recycled ? m_recycles : m_crashes);
+    }
+
+    if (index >= 0) {
+        Job& job = m_jobs[index];
+        if (job.attempts <= m_options.maxRetries) {
+            ++m_retried;
+            m_queue.prepend(index);
+        } else {
+            CFGAnalyzer::AnalysisResult failed;
+            failed.report = QString("Analysis worker died %1 time(s) on %2")
+                                .arg(job.attempts).arg(job.filePath).toStdString();
+            completeJob(index, std::move(failed));
+        }
+    }
+
+    if (m_batchActive) {
+        dispatch();
+    }
+}
+
+void CFGBridge::removeWorker(Worker* worker) {
+    auto it = std::find_if(m_workers.begin(), m_workers.end(),
+                           [worker](const auto& candidate) { return candidate.get() == worker; });
+    if (it == m_workers.end()) return;
+
+    worker->process->disconnect(this);
+    worker->process->deleteLater();
+    m_workers.erase(it);
+}
+
+void CFGBridge::completeJob(int index, CFGAnalyzer::AnalysisResult&& result) {
+    m_partials[index] = std::move(result);
+    ++m_completed;
+    emit progress(m_completed, static_cast<int>(m_jobs.size()));
+
+    if (m_completed == static_cast<int>(m_jobs.size())) {
+        finishBatch();
+    }
+}
+
+void CFGBridge::finishBatch() {
+    CFGAnalyzer::AnalysisResult merged;
+    QStringList failures;
+    for (size_t i = 0; i < m_partials.size(); ++i) {
+        if (!m_partials[i].success) {
+            failures << m_jobs[i].filePath + ": " + QString::fromStdString(m_partials[i].report);
+            continue;
+        }
+        CFGAnalyzer::CFGAnalyzer::mergeResult(merged, std::move(m_partials[i]));
+    }
+
+    merged.success = failures.size() < static_cast<int>(m_jobs.size());
+    merged.metrics.linkCalls(merged.functionDependencies);
+    merged.graph = CFGAnalyzer::CFGAnalyzer::buildCallGraph(merged);
+
+    QString report;
+    QTextStream stream(&report);
+    stream << "Out-of-Process Analysis Report\n"
+           << "==============================\n\n"
+           << "Translation units: " << m_jobs.size() << "\n"
+           << "Failed translation units: " << failures.size() << "\n"
+           << "Worker processes: " << m_options.workers << "\n"
+           << "Retried jobs: " << m_retried << "\n"
+           << "Worker crashes: " << m_crashes << "\n"
+           << "Worker recycles: " << m_recycles << "\n"
+           << "Wall time: " << m_timer.elapsed() << " ms\n\n";
+    for (const QString& failure : failures) {
+        stream << "FAILED " << failure << "\n";
+    }
+    if (!failures.isEmpty()) {
+        stream << "\n";
+    }
+    stream.flush();
+    merged.report = report.toStdString() + m_analyzer.generateReport(merged);
+
+    m_partials.clear();
+    m_batchActive = false;
+    m_result = std::move(merged);
+    emit analysisComplete(m_result);
+}
@@ -0,0 +1,169 @@
+#include "analysis_codec.h"
+#include <QDataStream>
+#include <QIODevice>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace CFGAnalyzer {
+namespace AnalysisCodec {
+
+namespace {
+
+constexpr quint32 Magic = 0x43464752; // "CFGR"
+constexpr quint16 Version = 4;
+
+void writeString(QDataStream& out, const std::string& value) {
+    out << QByteArray::fromStdString(value);
+}
+
+std::string readString(QDataStream& in) {
+    QByteArray value;
+    in >> value;
+    return value.toStdString();
+}
+
+} // namespace
+
+QByteArray encode(const AnalysisResult& result) {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+
+    out << Magic << Version << result.success;
+    writeString(out, result.report);
+    writeString(out, result.dotOutput);
+
+    // SymbolIds are local to this process, so symbols are written once as
+    // USRs and edges refer to their position in that list. Both are in name
+    // order so the encoding of a result is deterministic.
+    SymbolNames names(result.functionDependencies);
+    const SymbolTable& table = SymbolTable::instance();
+    std::unordered_map<SymbolId, quint32> indexes;
+    out << quint32(names.symbols().size());
+    for (SymbolId id : names.symbols()) {
+        const Symbol& symbol = table.symbol(id);
+        indexes.emplace(id, quint32(indexes.size()));
+        writeString(out, symbol.usr);
+        writeString(out, symbol.name);
+        writeString(out, symbol.parameters);
+    }
+
+    auto callers = names.sortedCallers();
+    out << quint32(callers.size());
+    for (const auto* entry : callers) {
+        out << indexes.at(entry->first) << quint32(entry->second.size());
+        for (SymbolId callee : names.sorted(entry->second)) {
+            out << indexes.at(callee);
+        }
+    }
+
+    out << quint32(result.functions.size());
+    for (const auto& [key, info] : result.functions) {
+        writeString(out, key);
+        writeString(out, info.name);
+        writeString(out, info.filename);
+        out << quint32(info.line) << quint32(info.column) << quint32(info.endLine)
+            << info.isMethod << info.isConstructor << info.isDestructor;
+    }
+
+    // Rows in table order, by symbol index; every analyzed function is a
+    // caller above. Fan-in and fan-out are recomputed by whoever merges the
+    // results.
+    out << quint32(result.metrics.size()) << quint32(MetricCount);
+    for (uint32_t row = 0; row < result.metrics.size(); ++row) {
+        out << indexes.at(result.metrics.symbol(row));
+        for (size_t m = 0; m < MetricCount; ++m) {
+            out << quint32(result.metrics.value(row, static_cast<Metric>(m)));
+        }
+    }
+
+    return data;
+}
+
+bool decode(const QByteArray& data, AnalysisResult& result) {
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != Magic || version != Version) {
+        return false;
+    }
+
+    in >> result.success;
+    result.report = readString(in);
+    result.dotOutput = readString(in);
+
+    quint32 symbolCount = 0;
+    in >> symbolCount;
+    std::vector<SymbolId> symbols;
+    for (quint32 i = 0; i < symbolCount && in.status() == QDataStream::Ok; ++i) {
+        std::string usr = readString(in);
+        std::string name = readString(in);
+        std::string parameters = readString(in);
+        symbols.push_back(SymbolTable::instance().intern(usr, name, parameters));
+    }
+
+    quint32 callerCount = 0;
+    in >> callerCount;
+    for (quint32 i = 0; i < callerCount && in.status() == QDataStream::Ok; ++i) {
+        quint32 caller = 0, calleeCount = 0;
+        in >> caller >> calleeCount;
+        if (caller >= symbols.size()) {
+            return false;
+        }
+        auto& callees = result.functionDependencies[symbols[caller]];
+        for (quint32 j = 0; j < calleeCount && in.status() == QDataStream::Ok; ++j) {
+            quint32 callee = 0;
+            in >> callee;
+            if (callee >= symbols.size()) {
+                return false;
+            }
+            callees.push_back(symbols[callee]);
+        }
+    }
+    normalizeCallGraph(result.functionDependencies);
+
+    quint32 functionCount = 0;
+    in >> functionCount;
+    for (quint32 i = 0; i < functionCount && in.status() == QDataStream::Ok; ++i) {
+        std::string key = readString(in);
+        FunctionInfo info;
+        info.name = readString(in);
+        info.filename = readString(in);
+        quint32 line = 0, column = 0, endLine = 0;
+        in >> line >> column >> endLine
+           >> info.isMethod >> info.isConstructor >> info.isDestructor;
+        info.line = line;
+        info.column = column;
+        info.endLine = endLine;
+        result.functions[key] = info;
+    }
+
+    quint32 metricsCount = 0, columnCount = 0;
+    in >> metricsCount >> columnCount;
+    if (columnCount != MetricCount) {
+        return false;
+    }
+    for (quint32 i = 0; i < metricsCount && in.status() == QDataStream::Ok; ++i) {
+        quint32 symbol = 0;
+        in >> symbol;
+        if (symbol >= symbols.size()) {
+            return false;
+        }
+        FunctionMetrics metrics;
+        for (size_t m = 0; m < MetricCount; ++m) {
+            quint32 value = 0;
+            in >> value;
+            metrics.values[m] = value;
+        }
+        result.metrics.set(symbols[symbol], metrics);
+    }
+
+    return in.status() == QDataStream::Ok;
+}
+
+} // namespace AnalysisCodec
+} // namespace CFGAnalyzer
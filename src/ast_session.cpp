@@ -0,0 +1,274 @@
+#include "ast_session.h"
+#include "shared_file_cache.h"
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Basic/DiagnosticOptions.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Serialization/PCHContainerOperations.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/Path.h>
+#include <chrono>
+#include <unordered_map>
+#include <QDebug>
+
+namespace CFGAnalyzer {
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+class BufferFile : public llvm::vfs::File {
+public:
+    BufferFile(llvm::vfs::Status status, std::shared_ptr<const std::string> contents)
+        : m_status(std::move(status)), m_contents(std::move(contents)) {}
+
+    llvm::ErrorOr<llvm::vfs::Status> status() override { return m_status; }
+
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> getBuffer(
+        const llvm::Twine& name, int64_t, bool, bool) override
+    {
+        return llvm::MemoryBuffer::getMemBufferCopy(*m_contents, name);
+    }
+
+    std::error_code close() override { return std::error_code(); }
+
+private:
+    llvm::vfs::Status m_status;
+    std::shared_ptr<const std::string> m_contents;
+};
+
+} // namespace
+
+// Serves unsaved editor buffers in place of the files they shadow and
+// forwards everything else to the shared file cache. Unlike
+// llvm::vfs::InMemoryFileSystem, a path's contents can be replaced.
+class UnsavedBufferFileSystem : public llvm::vfs::ProxyFileSystem {
+public:
+    UnsavedBufferFileSystem()
+        : ProxyFileSystem(SharedFileCache::instance().createFileSystem()) {}
+
+    void setBuffer(const std::string& path, const std::string& contents) {
+        std::string key = absolutePath(path);
+
+        // Keep the on-disk identity so the FileManager sees one file, and
+        // give every revision a fresh mtime.
+        auto onDisk = ProxyFileSystem::status(key);
+        llvm::sys::fs::UniqueID id = onDisk ? onDisk->getUniqueID()
+                                            : llvm::vfs::getNextVirtualUniqueID();
+        Buffer buffer;
+        buffer.contents = std::make_shared<const std::string>(contents);
+        buffer.status = llvm::vfs::Status(
+            key, id,
+            std::chrono::time_point_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now()),
+            0, 0, contents.size(),
+            llvm::sys::fs::file_type::regular_file,
+            llvm::sys::fs::all_read | llvm::sys::fs::owner_write);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers[key] = std::move(buffer);
+    }
+
+    void removeBuffer(const std::string& path) {
+        std::string key = absolutePath(path);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.erase(key);
+    }
+
+    llvm::ErrorOr<llvm::vfs::Status> status(const llvm::Twine& path) override {
+        Buffer buffer;
+        if (findBuffer(path, buffer)) {
+            return llvm::vfs::Status::copyWithNewName(buffer.status, path.str());
+        }
+        return ProxyFileSystem::status(path);
+    }
+
+    llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> openFileForRead(const llvm::Twine& path) override {
+        Buffer buffer;
+        if (findBuffer(path, buffer)) {
+            return std::unique_ptr<llvm::vfs::File>(new BufferFile(
+                llvm::vfs::Status::copyWithNewName(buffer.status, path.str()),
+                buffer.contents));
+        }
+        return ProxyFileSystem::openFileForRead(path);
+    }
+
+private:
+    struct Buffer {
+        llvm::vfs::Status status;
+        std::shared_ptr<const std::string> contents;
+    };
+
+    std::string absolutePath(const llvm::Twine& path) const {
+        llvm::SmallString<256> absolute;
+        path.toVector(absolute);
+        makeAbsolute(absolute);
+        llvm::sys::path::remove_dots(absolute, /*remove_dot_dot=*/true);
+        return std::string(absolute.str());
+    }
+
+    bool findBuffer(const llvm::Twine& path, Buffer& buffer) const {
+        std::string key = absolutePath(path);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_buffers.find(key);
+        if (it == m_buffers.end()) {
+            return false;
+        }
+        buffer = it->second;
+        return true;
+    }
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Buffer> m_buffers;
+};
+
+ASTSession::ASTSession(std::vector<std::string> compileArgs)
+    : m_compileArgs(std::move(compileArgs)),
+      m_overlay(llvm::makeIntrusiveRefCnt<UnsavedBufferFileSystem>())
+{
+}
+
+ASTSession::~ASTSession() = default;
+
+std::vector<std::string> ASTSession::defaultArgs() {
+    return {
+        "-x", "c++",
+        "-std=c++17",
+        "-I.",
+        "-I/usr/include",
+        "-I/usr/local/include"
+    };
+}
+
+std::string ASTSession::resourceDir() {
+#ifdef CFG_CLANG_RESOURCE_DIR
+    return CFG_CLANG_RESOURCE_DIR;
+#else
+    return std::string();
+#endif
+}
+
+std::unique_ptr<clang::ASTUnit> ASTSession::loadUnit(
+    const std::string& filePath,
+    const std::vector<std::string>& compileArgs,
+    unsigned precompilePreambleAfterNParses,
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> fileSystem)
+{
+    std::vector<const char*> args;
+    args.reserve(compileArgs.size() + 2);
+    args.push_back("clang");
+    for (const auto& arg : compileArgs) {
+        args.push_back(arg.c_str());
+    }
+    args.push_back(filePath.c_str());
+
+    clang::IntrusiveRefCntPtr<clang::DiagnosticsEngine> diags =
+        clang::CompilerInstance::createDiagnostics(new clang::DiagnosticOptions(),
+                                                   new clang::IgnoringDiagConsumer());
+
+    return clang::ASTUnit::LoadFromCommandLine(
+        args.data(), args.data() + args.size(),
+        std::make_shared<clang::PCHContainerOperations>(),
+        diags,
+        resourceDir(),
+        /*StorePreamblesInMemory=*/true,
+        /*PreambleStoragePath=*/llvm::StringRef(),
+        /*OnlyLocalDecls=*/false,
+        clang::CaptureDiagsKind::None,
+        /*RemappedFiles=*/std::nullopt,
+        /*RemappedFilesKeepOriginalName=*/true,
+        precompilePreambleAfterNParses,
+        clang::TU_Complete,
+        /*CacheCodeCompletionResults=*/false,
+        /*IncludeBriefCommentsInCodeCompletion=*/false,
+        /*AllowPCHWithCompilerErrors=*/false,
+        clang::SkipFunctionBodiesScope::None,
+        /*SingleFileParse=*/false,
+        /*UserFilesAreVolatile=*/false,
+        /*ForSerialization=*/false,
+        /*RetainExcludedConditionalBlocks=*/false,
+        /*ModuleFormat=*/std::nullopt,
+        /*ErrAST=*/nullptr,
+        fileSystem ? fileSystem : SharedFileCache::instance().createFileSystem());
+}
+
+std::shared_ptr<ASTSession::Entry> ASTSession::entryFor(const std::string& filePath) {
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+    auto& entry = m_entries[filePath];
+    if (!entry) {
+        entry = std::make_shared<Entry>();
+    }
+    return entry;
+}
+
+bool ASTSession::withAST(const std::string& filePath,
+                         const std::function<void(clang::ASTUnit&)>& fn,
+                         bool reparse)
+{
+    auto entry = entryFor(filePath);
+    std::lock_guard<std::mutex> lock(entry->mutex);
+
+    auto start = std::chrono::steady_clock::now();
+    if (!entry->unit) {
+        entry->unit = loadUnit(filePath, m_compileArgs, /*precompilePreambleAfterNParses=*/1,
+                               m_overlay);
+        if (!entry->unit) {
+            qCritical() << "Failed to build AST for:" << filePath.c_str();
+            return false;
+        }
+        entry->timings = Timings();
+        entry->timings.firstParseMs = millisecondsSince(start);
+        qDebug() << "First parse of" << filePath.c_str() << "took"
+                 << entry->timings.firstParseMs << "ms";
+    } else if (reparse) {
+        // Reparse re-reads the main file and reuses the precompiled preamble
+        // unless one of its headers (or the include block itself) changed.
+        if (entry->unit->Reparse(std::make_shared<clang::PCHContainerOperations>())) {
+            qCritical() << "Failed to reparse:" << filePath.c_str();
+            entry->unit.reset();
+            return false;
+        }
+        entry->timings.lastReparseMs = millisecondsSince(start);
+        ++entry->timings.reparseCount;
+        qDebug() << "Reparse of" << filePath.c_str() << "took"
+                 << entry->timings.lastReparseMs << "ms";
+    }
+
+    fn(*entry->unit);
+    return true;
+}
+
+ASTSession::Timings ASTSession::timings(const std::string& filePath) const {
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(m_entriesMutex);
+        auto it = m_entries.find(filePath);
+        if (it == m_entries.end()) {
+            return Timings();
+        }
+        entry = it->second;
+    }
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    return entry->timings;
+}
+
+void ASTSession::invalidate(const std::string& filePath) {
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+    m_entries.erase(filePath);
+}
+
+void ASTSession::clear() {
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+    m_entries.clear();
+}
+
+void ASTSession::setUnsavedBuffer(const std::string& filePath, const std::string& contents) {
+    m_overlay->setBuffer(filePath, contents);
+}
+
+void ASTSession::clearUnsavedBuffer(const std::string& filePath) {
+    m_overlay->removeBuffer(filePath);
+}
+
+} // namespace CFGAnalyzer
@@ -3,15 +3,29 @@
 #include "cfg_analyzer.h"
 #include "parser.h"
 #include "graph_generator.h"
-#include "visualizer.h"
+#include "graph_analysis.h"
+#include "worker_pool.h"
+#include "ast_session.h"
+#include "summary_cache.h"
+#include "shared_file_cache.h"
 #include <QString>
+#include <clang/Lex/Lexer.h>
+#include <clang/Tooling/ArgumentsAdjusters.h>
 #include <clang/Tooling/Tooling.h>
 #include <clang/Tooling/CommonOptionsParser.h>
+#include <clang/Tooling/CompilationDatabase.h>
+#include <clang/Tooling/JSONCompilationDatabase.h>
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/VirtualFileSystem.h>
+#include <llvm/Support/xxhash.h>
+#include <llvm/ADT/StringExtras.h>
 #include <iomanip>
+#include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <mutex>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
@@ -24,7 +38,12 @@ AnalysisResult::AnalysisResult(AnalysisResult&& other) noexcept
       report(std::move(other.report)),
       success(other.success),
       functionDependencies(std::move(other.functionDependencies)),
-      functions(std::move(other.functions))
+      functions(std::move(other.functions)),
+      changedFunctions(std::move(other.changedFunctions)),
+      graph(std::move(other.graph)),
+      metrics(std::move(other.metrics)),
+      functionDots(std::move(other.functionDots)),
+      arenaStats(other.arenaStats)
 {
 }
 
@@ -36,6 +55,11 @@ AnalysisResult& AnalysisResult::operator=(AnalysisResult&& other) noexcept {
         success = other.success;
         functionDependencies = std::move(other.functionDependencies);
         functions = std::move(other.functions);
+        changedFunctions = std::move(other.changedFunctions);
+        graph = std::move(other.graph);
+        metrics = std::move(other.metrics);
+        functionDots = std::move(other.functionDots);
+        arenaStats = other.arenaStats;
     }
     return *this;
 }
@@ -44,6 +68,199 @@ AnalysisResult::~AnalysisResult() {
     // Destructor implementation
 }
 
+namespace {
+
+// Records every file the preprocessor opens, system headers included, so a
+// cached summary can be invalidated by a change anywhere in the TU.
+class TUDependencyCollector : public clang::DependencyCollector {
+public:
+    bool needSystemDependencies() override { return true; }
+};
+
+std::string sourceText(clang::SourceRange range, const clang::ASTContext& context) {
+    return clang::Lexer::getSourceText(clang::CharSourceRange::getTokenRange(range),
+                                       context.getSourceManager(),
+                                       context.getLangOpts()).str();
+}
+
+// Describes every declaration a function body refers to. Anything that can
+// change the CFG without touching the body text is part of the description:
+// the type, constant initializers and enumerator values (branches on
+// constants are pruned) and noreturn (edges after the call are dropped).
+class ReferencedDeclCollector : public clang::RecursiveASTVisitor<ReferencedDeclCollector> {
+public:
+    explicit ReferencedDeclCollector(const clang::ASTContext& context) : m_context(context) {}
+
+    bool VisitDeclRefExpr(clang::DeclRefExpr* E) { add(E->getDecl()); return true; }
+    bool VisitMemberExpr(clang::MemberExpr* E) { add(E->getMemberDecl()); return true; }
+    bool VisitCXXConstructExpr(clang::CXXConstructExpr* E) { add(E->getConstructor()); return true; }
+
+    const std::set<std::string>& references() const { return m_references; }
+
+private:
+    void add(const clang::ValueDecl* D) {
+        if (!D) return;
+        std::string reference = D->getQualifiedNameAsString() + ":" + D->getType().getAsString();
+        if (const auto* var = llvm::dyn_cast<clang::VarDecl>(D)) {
+            if (var->getType().isConstQualified() && var->getInit()) {
+                reference += "=" + sourceText(var->getInit()->getSourceRange(), m_context);
+            }
+        } else if (const auto* enumerator = llvm::dyn_cast<clang::EnumConstantDecl>(D)) {
+            reference += "=" + llvm::toString(enumerator->getInitVal(), 10);
+        } else if (const auto* function = llvm::dyn_cast<clang::FunctionDecl>(D)) {
+            if (function->isNoReturn()) {
+                reference += " noreturn";
+            }
+        }
+        m_references.insert(reference);
+    }
+
+    const clang::ASTContext& m_context;
+    std::set<std::string> m_references;
+};
+
+// Blocks and edges of cfg without any text, keyed by block id. Edges out
+// of a try dispatch block lead into its handlers and are marked as
+// exception edges.
+std::shared_ptr<const GraphGenerator::FrozenGraph> blockSkeleton(
+    const clang::CFG& cfg, GraphGenerator::GraphArena::Stats& arenaStats)
+{
+    GraphGenerator::CFGGraph skeleton;
+    for (const clang::CFGBlock* block : cfg) {
+        skeleton.addNode(block->getBlockID());
+    }
+    for (const clang::CFGBlock* block : cfg) {
+        bool dispatch = llvm::isa_and_nonnull<clang::CXXTryStmt>(block->getTerminatorStmt());
+        for (auto it = block->succ_begin(); it != block->succ_end(); ++it) {
+            if (!*it) continue;
+            if (dispatch) {
+                skeleton.addExceptionEdge(block->getBlockID(), (*it)->getBlockID());
+            } else {
+                skeleton.addEdge(block->getBlockID(), (*it)->getBlockID());
+            }
+        }
+    }
+    arenaStats += skeleton.arenaStats();
+    return skeleton.freeze();
+}
+
+// Block ids of the loop headers and branch entries of the region forest
+// of a skeleton; these are the blocks a viewer can fold.
+std::set<unsigned> regionEntryBlocks(const GraphGenerator::FrozenGraph& skeleton) {
+    const GraphGenerator::RegionForest& regions = skeleton.regions();
+    std::set<unsigned> entries;
+    for (uint32_t r = 0; r < regions.size(); ++r) {
+        entries.insert(static_cast<unsigned>(skeleton.id(regions[r].entry)));
+    }
+    return entries;
+}
+
+// Metrics of the most complex functions, one line each.
+std::string metricsSummary(const MetricsTable& metrics, size_t limit = 10) {
+    if (metrics.empty()) return "";
+    std::vector<uint32_t> rows = metrics.select(Metric::Cyclomatic);
+    size_t shown = std::min(limit, rows.size());
+    std::stringstream summary;
+    summary << "Function metrics: " << metrics.size() << " function(s), top " << shown
+            << " by cyclomatic complexity\n";
+    for (size_t i = 0; i < shown; ++i) {
+        summary << "  " << metrics.name(rows[i]) << ":";
+        const char* separator = " ";
+        for (size_t m = 0; m < MetricCount; ++m) {
+            Metric metric = static_cast<Metric>(m);
+            summary << separator << metricName(metric) << " " << metrics.value(rows[i], metric);
+            separator = ", ";
+        }
+        summary << "\n";
+    }
+    return summary.str();
+}
+
+// Strongly connected components of a call graph, listing the recursive
+// ones under the ids the GUI shows for the same graph.
+std::string componentSummary(const GraphGenerator::FrozenGraph* graph) {
+    if (!graph) return "";
+    const GraphGenerator::StronglyConnectedComponents& components = graph->components();
+    std::stringstream summary;
+    summary << "Call graph components: " << components.size() << " ("
+            << components.cyclicCount() << " recursive)\n";
+    for (uint32_t c = 0; c < components.size(); ++c) {
+        if (!components.isCyclic(c)) continue;
+        summary << "  SCC " << c << ":";
+        const char* separator = " ";
+        for (uint32_t member : components.members(c)) {
+            summary << separator << graph->label(member).toStdString();
+            separator = ", ";
+        }
+        summary << "\n";
+    }
+    return summary.str();
+}
+
+std::string fileCacheSummary(const SharedFileCache::Stats& before) {
+    SharedFileCache::Stats after = SharedFileCache::instance().stats();
+    std::stringstream summary;
+    summary << "File cache: " << (after.statHits - before.statHits) << " stat(s) and "
+            << (after.readHits - before.readHits) << " read(s) served from memory, "
+            << (after.statMisses - before.statMisses) << " stat(s) and "
+            << (after.readMisses - before.readMisses) << " read(s) hit the disk, "
+            << (after.evictions - before.evictions) << " file(s) evicted\n";
+    return summary.str();
+}
+
+// Graph containers used to be one heap allocation (and one free) each; the
+// arena serves them from a few blocks released with the graph.
+std::string graphArenaSummary(const GraphGenerator::GraphArena::Stats& stats) {
+    std::stringstream summary;
+    summary << "Graph allocations: " << stats.allocations
+            << " served from " << stats.blocks << " arena block(s) ("
+            << stats.bytes / 1024 << " KiB)\n";
+    return summary.str();
+}
+
+std::string dotFailureSummary(const std::vector<std::string>& failed) {
+    if (failed.empty()) {
+        return std::string();
+    }
+    std::stringstream summary;
+    summary << "Failed to write " << failed.size() << " CFG file(s):\n";
+    for (const auto& path : failed) {
+        summary << "  - " << path << "\n";
+    }
+    return summary.str();
+}
+
+// Moves every location="file:start-end" attribute by delta lines, for a
+// cached CFG whose function only moved within the file.
+std::string shiftDotLocations(const std::string& dot, int delta) {
+    static const std::string marker = "location=\"";
+    std::string shifted;
+    shifted.reserve(dot.size());
+
+    size_t pos = 0;
+    while (true) {
+        size_t found = dot.find(marker, pos);
+        if (found == std::string::npos) break;
+        size_t valueStart = found + marker.size();
+        size_t valueEnd = dot.find('"', valueStart);
+        size_t colon = dot.rfind(':', valueEnd);
+        size_t dash = dot.find('-', colon);
+        if (valueEnd == std::string::npos || colon == std::string::npos ||
+            colon < valueStart || dash == std::string::npos || dash > valueEnd) {
+            break;
+        }
+        int startLine = std::stoi(dot.substr(colon + 1, dash - colon - 1));
+        int endLine = std::stoi(dot.substr(dash + 1, valueEnd - dash - 1));
+        shifted.append(dot, pos, colon + 1 - pos);
+        shifted += std::to_string(startLine + delta) + "-" + std::to_string(endLine + delta);
+        pos = valueEnd;
+    }
+    shifted.append(dot, pos, std::string::npos);
+    return shifted;
+}
+
+} // namespace
+
 class FunctionCallVisitor {
 public:
     FunctionCallVisitor() = default;
@@ -57,18 +274,20 @@ private:
 };
 
 CFGVisitor::CFGVisitor(clang::ASTContext* Context,
-                     const std::string& outputDir,
                      AnalysisResult& results)
     : Context(Context), 
-      OutputDir(outputDir), 
       m_results(results) 
 {
-    if (!llvm::sys::fs::exists(outputDir)) {
-        llvm::sys::fs::create_directory(outputDir);
-    }
 }
 
 std::string CFGVisitor::stmtToString(const clang::Stmt* S) {
+    if (!m_prettyPrintLabels) {
+        llvm::StringRef spelling = GraphGenerator::getStmtSourceText(S, *Context);
+        if (!spelling.empty()) {
+            return spelling.str();
+        }
+    }
+
     std::string stmtStr;
     llvm::raw_string_ostream rso(stmtStr);
     S->printPretty(rso, nullptr, Context->getPrintingPolicy());
@@ -97,19 +316,15 @@ std::string CFGVisitor::generateDotFromCFG(clang::FunctionDecl* FD) {
     dot << "  node [shape=rectangle, style=filled, fillcolor=lightgray];\n";
     dot << "  edge [arrowhead=vee, penwidth=2, weight=10, color=\"#666666\"];\n\n";
 
-    std::map<const clang::CFGBlock*, std::vector<const clang::CFGBlock*>> blockHierarchy;
-
-    for (const clang::CFGBlock* block : *cfg) {
-        for (auto it = block->succ_begin(); it != block->succ_end(); ++it) {
-            if (*it && (*it)->getBlockID() > block->getBlockID()) {
-                blockHierarchy[block].push_back(*it);
-            }
-        }
-    }
+    // Only loops and single-entry single-exit branches can be folded. The
+    // same skeleton is measured for the metrics table.
+    std::shared_ptr<const GraphGenerator::FrozenGraph> skeleton =
+        blockSkeleton(*cfg, m_results.arenaStats);
+    std::set<unsigned> collapsible = regionEntryBlocks(*skeleton);
+    FunctionMetrics metrics;
 
     for (const clang::CFGBlock* block : *cfg) {
-        bool isCollapsible = blockHierarchy.find(block) != blockHierarchy.end() && 
-                           !blockHierarchy[block].empty();
+        bool isCollapsible = collapsible.count(block->getBlockID()) != 0;
 
         dot << "  B" << block->getBlockID() << " [label=\"";
         
@@ -124,6 +339,7 @@ std::string CFGVisitor::generateDotFromCFG(clang::FunctionDecl* FD) {
         for (const auto& elem : *block) {
             if (elem.getKind() == clang::CFGElement::Statement) {
                 if (const clang::Stmt* stmt = elem.castAs<clang::CFGStmt>().getStmt()) {
+                    ++metrics[Metric::Statements];
                     if (!firstStmt) dot << "\\n";
                     dot << escapeDotLabel(stmtToString(stmt));
                     firstStmt = false;
@@ -186,6 +402,7 @@ std::string CFGVisitor::generateDotFromCFG(clang::FunctionDecl* FD) {
     }
 
     dot << "}\n";
+    m_results.metrics.set(symbolFor(FD), metrics, std::move(skeleton));
     return dot.str();
 }
 
@@ -219,76 +436,278 @@ bool CFGVisitor::VisitFunctionDecl(clang::FunctionDecl* FD) {
     
     std::string funcName = FD->getQualifiedNameAsString();
     CurrentFunction = funcName;
-    FunctionDependencies[funcName] = std::set<std::string>();
-    
-    std::string dotContent = generateDotFromCFG(FD);
-    if (!dotContent.empty()) {
-        std::string filename = OutputDir + "/" + funcName + "_cfg.dot";
-        std::ofstream outFile(filename);
-        if (outFile) {
-            outFile << dotContent;
-            outFile.close();
+    m_currentSymbol = symbolFor(FD);
+    FunctionDependencies[m_currentSymbol];
+    recordFunction(FD, funcName);
+
+    if (!m_targetFunction.empty()) {
+        if (funcName != m_targetFunction) return true;
+        m_results.graph = functionGraph(FD, funcName);
+        // The only CFG the caller asked for is built; stop the traversal.
+        return false;
+    }
+
+    if (!m_buildCFGs) {
+        dropStaleSnapshot(FD, funcName);
+        return true;
+    }
+    if (!m_emitDots && !m_snapshots) {
+        measureFunction(FD);
+        return true;
+    }
+
+    emitFunctionCFG(FD, funcName);
+    return true;
+}
+
+void CFGVisitor::recordFunction(clang::FunctionDecl* FD, const std::string& funcName) {
+    clang::SourceManager& SM = Context->getSourceManager();
+
+    FunctionInfo info;
+    info.name = funcName;
+    info.filename = SM.getFilename(FD->getLocation()).str();
+    info.line = SM.getSpellingLineNumber(FD->getBeginLoc());
+    info.column = SM.getSpellingColumnNumber(FD->getBeginLoc());
+    info.endLine = SM.getSpellingLineNumber(FD->getEndLoc());
+    if (const auto* method = llvm::dyn_cast<clang::CXXMethodDecl>(FD)) {
+        info.isMethod = true;
+        info.isConstructor = llvm::isa<clang::CXXConstructorDecl>(method);
+        info.isDestructor = llvm::isa<clang::CXXDestructorDecl>(method);
+    }
+    m_results.functions.emplace(funcName, info);
+}
+
+std::string CFGVisitor::snapshotKey(clang::FunctionDecl* FD, const std::string& funcName) {
+    return funcName + ":" + FD->getType().getAsString();
+}
+
+void CFGVisitor::dropStaleSnapshot(clang::FunctionDecl* FD, const std::string& funcName) {
+    if (!m_snapshots) return;
+
+    std::string key = snapshotKey(FD, funcName);
+    m_visitedSnapshots.insert(key);
+
+    // Only functions that were already rendered pay for a fingerprint here.
+    auto it = m_snapshots->find(key);
+    if (it == m_snapshots->end()) return;
+    if (it->second.fingerprint != fingerprintFunction(FD)) {
+        m_snapshots->erase(it);
+        m_results.changedFunctions.push_back(funcName);
+    } else if (it->second.measured) {
+        m_results.metrics.set(symbolFor(FD), it->second.metrics);
+    }
+}
+
+std::string CFGVisitor::emitFunctionCFG(clang::FunctionDecl* FD, const std::string& funcName) {
+    clang::SourceManager& SM = Context->getSourceManager();
+
+    std::string dotContent;
+    if (m_snapshots) {
+        std::string key = snapshotKey(FD, funcName);
+        m_visitedSnapshots.insert(key);
+
+        uint64_t fingerprint = fingerprintFunction(FD);
+        unsigned startLine = SM.getSpellingLineNumber(FD->getBeginLoc());
+        FunctionSnapshot& snapshot = (*m_snapshots)[key];
+        if (!snapshot.dot.empty() && snapshot.measured && snapshot.fingerprint == fingerprint) {
+            m_results.metrics.set(symbolFor(FD), snapshot.metrics);
+            if (snapshot.startLine == startLine) {
+                return snapshot.dot;
+            }
+            // Same body, new position: only the line numbers need rewriting.
+            snapshot.dot = shiftDotLocations(snapshot.dot,
+                                             static_cast<int>(startLine) - static_cast<int>(snapshot.startLine));
+            snapshot.startLine = startLine;
+            snapshot.graph.reset();
+            dotContent = snapshot.dot;
+        } else {
+            dotContent = generateDotFromCFG(FD);
+            snapshot.name = funcName;
+            snapshot.symbol = symbolFor(FD);
+            snapshot.fingerprint = fingerprint;
+            snapshot.startLine = startLine;
+            snapshot.dot = dotContent;
+            snapshot.graph.reset();
+            snapshot.measured = false;
+            m_results.changedFunctions.push_back(funcName);
         }
+    } else {
+        dotContent = generateDotFromCFG(FD);
+    }
+
+    // Written by CFGAnalyzer::writeFunctionDots once translation units are
+    // merged, so parallel units never write the same file.
+    if (m_emitDots && !dotContent.empty()) {
+        m_results.functionDots[funcName] = dotContent;
     }
     
-    return true;
+    return dotContent;
+}
+
+// Metrics of FD without rendering its CFG.
+void CFGVisitor::measureFunction(clang::FunctionDecl* FD) {
+    std::unique_ptr<clang::CFG> cfg = clang::CFG::buildCFG(
+        FD, FD->getBody(), Context, clang::CFG::BuildOptions());
+    if (!cfg) return;
+
+    FunctionMetrics metrics;
+    for (const clang::CFGBlock* block : *cfg) {
+        for (const auto& elem : *block) {
+            if (elem.getKind() == clang::CFGElement::Statement &&
+                elem.castAs<clang::CFGStmt>().getStmt()) {
+                ++metrics[Metric::Statements];
+            }
+        }
+    }
+    m_results.metrics.set(symbolFor(FD), metrics, blockSkeleton(*cfg, m_results.arenaStats));
+}
+
+std::shared_ptr<const GraphGenerator::FrozenGraph> CFGVisitor::functionGraph(
+    clang::FunctionDecl* FD, const std::string& funcName)
+{
+    auto build = [this, FD]() -> std::shared_ptr<const GraphGenerator::FrozenGraph> {
+        auto graph = GraphGenerator::generateCFG(
+            FD, m_strings,
+            m_prettyPrintLabels ? GraphGenerator::LabelMode::PrettyPrint
+                                : GraphGenerator::LabelMode::SourceSlice);
+        if (!graph) {
+            return nullptr;
+        }
+        m_results.arenaStats += graph->arenaStats();
+        return graph->freeze();
+    };
+    if (!m_snapshots) {
+        return build();
+    }
+
+    clang::SourceManager& SM = Context->getSourceManager();
+    uint64_t fingerprint = fingerprintFunction(FD);
+    unsigned startLine = SM.getSpellingLineNumber(FD->getBeginLoc());
+    FunctionSnapshot& snapshot = (*m_snapshots)[snapshotKey(FD, funcName)];
+    if (snapshot.fingerprint == fingerprint && (snapshot.graph || !snapshot.dot.empty())) {
+        int delta = static_cast<int>(startLine) - static_cast<int>(snapshot.startLine);
+        if (delta != 0) {
+            // Published graphs are shared with the GUI; shift a copy.
+            if (snapshot.graph) {
+                snapshot.graph = snapshot.graph->withLinesShifted(delta);
+            }
+            if (!snapshot.dot.empty()) {
+                snapshot.dot = shiftDotLocations(snapshot.dot, delta);
+            }
+            snapshot.startLine = startLine;
+        }
+        if (snapshot.graph) {
+            return snapshot.graph;
+        }
+    } else {
+        snapshot.dot.clear();
+        snapshot.measured = false;
+        m_results.changedFunctions.push_back(funcName);
+    }
+
+    snapshot.name = funcName;
+    snapshot.symbol = symbolFor(FD);
+    snapshot.fingerprint = fingerprint;
+    snapshot.startLine = startLine;
+    snapshot.graph = build();
+    return snapshot.graph;
+}
+
+uint64_t CFGVisitor::fingerprintFunction(clang::FunctionDecl* FD) {
+    std::string data = sourceText(FD->getSourceRange(), *Context);
+
+    ReferencedDeclCollector collector(*Context);
+    collector.TraverseStmt(FD->getBody());
+    for (const auto& reference : collector.references()) {
+        data += '\0';
+        data += reference;
+    }
+    return llvm::xxh3_64bits(data);
 }
 
 bool CFGVisitor::VisitCallExpr(clang::CallExpr* CE) {
     if (!CurrentFunction.empty() && CE) {
         if (auto* CalledFunc = CE->getDirectCallee()) {
-            FunctionDependencies[CurrentFunction].insert(
-                CalledFunc->getQualifiedNameAsString());
+            FunctionDependencies[m_currentSymbol].push_back(symbolFor(CalledFunc));
         }
     }
     return true;
 }
 
+SymbolId CFGVisitor::symbolFor(const clang::FunctionDecl* FD) {
+    FD = FD->getCanonicalDecl();
+    auto it = m_symbolIds.find(FD);
+    if (it == m_symbolIds.end()) {
+        it = m_symbolIds.emplace(FD, SymbolTable::instance().intern(FD)).first;
+    }
+    return it->second;
+}
+
 void CFGVisitor::PrintFunctionDependencies() const {
+    CallGraph calls = GetFunctionDependencies();
+    SymbolNames names(calls);
     llvm::outs() << "Function Dependencies:\n";
-    for (const auto& [caller, callees] : FunctionDependencies) {
-        llvm::outs() << caller << " calls:\n";
-        for (const auto& callee : callees) {
-            llvm::outs() << "  - " << callee << "\n";
+    for (const auto* entry : names.sortedCallers()) {
+        llvm::outs() << names[entry->first] << " calls:\n";
+        for (SymbolId callee : names.sorted(entry->second)) {
+            llvm::outs() << "  - " << names[callee] << "\n";
         }
     }
 }
 
-std::unordered_map<std::string, std::set<std::string>> 
-CFGVisitor::GetFunctionDependencies() const {
-    return FunctionDependencies;
+CallGraph CFGVisitor::GetFunctionDependencies() const {
+    CallGraph calls = FunctionDependencies;
+    normalizeCallGraph(calls);
+    return calls;
 }
 
-void CFGVisitor::FinalizeCombinedFile() {
-    std::string combinedFilename = OutputDir + "/combined_cfg.dot";
-    if (llvm::sys::fs::exists(combinedFilename)) {
-        std::ofstream outFile(combinedFilename, std::ios::app);
-        if (outFile.is_open()) {
-            outFile << "}\n";
-            outFile.close();
+void CFGVisitor::Finalize() {
+    if (m_snapshots) {
+        for (auto it = m_snapshots->begin(); it != m_snapshots->end();) {
+            if (m_visitedSnapshots.count(it->first)) {
+                ++it;
+                continue;
+            }
+            m_results.changedFunctions.push_back(it->second.name);
+            it = m_snapshots->erase(it);
         }
     }
     
-    m_results.functionDependencies = FunctionDependencies;
+    // A file with several compile commands is visited once per command,
+    // all into the same result; each run adds to the calls found so far.
+    normalizeCallGraph(FunctionDependencies);
+    mergeCallGraph(m_results.functionDependencies, CallGraph(FunctionDependencies));
 }
 
 CFGConsumer::CFGConsumer(clang::ASTContext* Context,
-                       const std::string& outputDir,
-                       AnalysisResult& results)
-    : Visitor(std::make_unique<CFGVisitor>(Context, outputDir, results)) {}
+                       AnalysisResult& results,
+                       bool emitDots,
+                       bool prettyPrintLabels)
+    : Visitor(std::make_unique<CFGVisitor>(Context, results))
+{
+    Visitor->setEmitDots(emitDots);
+    Visitor->setPrettyPrintLabels(prettyPrintLabels);
+}
 
 void CFGConsumer::HandleTranslationUnit(clang::ASTContext& Context) {
     Visitor->TraverseDecl(Context.getTranslationUnitDecl());
-    Visitor->FinalizeCombinedFile();
+    Visitor->Finalize();
 }
 
-CFGAction::CFGAction(const std::string& outputDir,
-                   AnalysisResult& results)
-    : OutputDir(outputDir), m_results(results) {}
+CFGAction::CFGAction(AnalysisResult& results,
+                   std::shared_ptr<clang::DependencyCollector> dependencies,
+                   bool emitDots,
+                   bool prettyPrintLabels)
+    : m_results(results), m_dependencies(std::move(dependencies)), m_emitDots(emitDots),
+      m_prettyPrintLabels(prettyPrintLabels) {}
 
 std::unique_ptr<clang::ASTConsumer> CFGAction::CreateASTConsumer(
     clang::CompilerInstance& CI, llvm::StringRef File) {
-    return std::make_unique<CFGConsumer>(&CI.getASTContext(), OutputDir, m_results);
+    if (m_dependencies) {
+        m_dependencies->attachToPreprocessor(CI.getPreprocessor());
+    }
+    return std::make_unique<CFGConsumer>(&CI.getASTContext(), m_results, m_emitDots,
+                                         m_prettyPrintLabels);
 }
 
 class CFGAnalyzer::Impl {
@@ -296,6 +715,33 @@ public:
     Impl() : m_analysisMutex() {}
     
     QMutex m_analysisMutex;
+    ASTSession m_session;
+    std::unique_ptr<SummaryCache> m_cache;
+
+    // Per-file function snapshots for analyzeFile. Each file's map is only
+    // touched while ASTSession holds that file's lock.
+    std::mutex m_snapshotsMutex;
+    std::map<std::string, FunctionSnapshotMap> m_snapshots;
+
+    FunctionSnapshotMap& snapshotsFor(const std::string& filename) {
+        std::lock_guard<std::mutex> lock(m_snapshotsMutex);
+        return m_snapshots[filename];
+    }
+
+    // Statement text of every CFG built in this session. Once the pool
+    // grows past the limit a fresh one is started; graphs still holding the
+    // old pool keep it alive until they are dropped.
+    static constexpr size_t kMaxStringPoolBytes = 64 * 1024 * 1024;
+    std::mutex m_stringsMutex;
+    std::shared_ptr<GraphGenerator::StringPool> m_strings = std::make_shared<GraphGenerator::StringPool>();
+
+    std::shared_ptr<GraphGenerator::StringPool> stringPool() {
+        std::lock_guard<std::mutex> lock(m_stringsMutex);
+        if (m_strings->bytesAllocated() > kMaxStringPoolBytes) {
+            m_strings = std::make_shared<GraphGenerator::StringPool>();
+        }
+        return m_strings;
+    }
 };
 
 CFGAnalyzer::CFGAnalyzer() : m_impl(std::make_unique<Impl>()) {
@@ -304,8 +750,39 @@ CFGAnalyzer::CFGAnalyzer() : m_impl(std::make_unique<Impl>()) {
 CFGAnalyzer::~CFGAnalyzer() {
 }
 
-AnalysisResult CFGAnalyzer::analyze(const std::string& filename) {
-    AnalysisResult result;
+void CFGAnalyzer::setOptions(const AnalysisOptions& options) {
+    m_options = options;
+
+    if (options.cacheDir.empty()) {
+        m_impl->m_cache.reset();
+    } else if (!m_impl->m_cache ||
+               m_impl->m_cache->directory() != options.cacheDir ||
+               m_impl->m_cache->maxBytes() != options.cacheMaxBytes) {
+        m_impl->m_cache = std::make_unique<SummaryCache>(options.cacheDir, options.cacheMaxBytes);
+    }
+}
+
+uint64_t CFGAnalyzer::cacheHits() const {
+    return m_impl->m_cache ? m_impl->m_cache->stats().hits : 0;
+}
+
+uint64_t CFGAnalyzer::cacheMisses() const {
+    return m_impl->m_cache ? m_impl->m_cache->stats().misses : 0;
+}
+
+std::string CFGAnalyzer::cacheSummary(uint64_t hitsBefore, uint64_t missesBefore) const {
+    if (!m_impl->m_cache) {
+        return std::string();
+    }
+    SummaryCache::Stats stats = m_impl->m_cache->stats();
+    std::stringstream summary;
+    summary << "Summary cache: " << (stats.hits - hitsBefore) << " hit(s), "
+            << (stats.misses - missesBefore) << " miss(es), "
+            << stats.evictions << " eviction(s) total\n";
+    return summary.str();
+}
+
+std::unique_ptr<clang::tooling::CompilationDatabase> CFGAnalyzer::defaultCompilations() {
     std::vector<std::string> CommandLine = {
         "-std=c++17",
         "-I.",
@@ -313,30 +790,121 @@ AnalysisResult CFGAnalyzer::analyze(const std::string& filename) {
         "-I/usr/local/include"
     };
 
-    auto Compilations = std::make_unique<clang::tooling::FixedCompilationDatabase>(
+    return std::make_unique<clang::tooling::FixedCompilationDatabase>(
         ".", CommandLine);
+}
+
+std::unique_ptr<clang::tooling::CompilationDatabase> CFGAnalyzer::loadCompilations(
+    const std::string& buildPath, std::string& errorMessage)
+{
+    if (llvm::StringRef(buildPath).ends_with(".json")) {
+        return clang::tooling::JSONCompilationDatabase::loadFromFile(
+            buildPath, errorMessage, clang::tooling::JSONCommandLineSyntax::AutoDetect);
+    }
+    return clang::tooling::CompilationDatabase::loadFromDirectory(buildPath, errorMessage);
+}
+
+AnalysisResult CFGAnalyzer::analyze(const std::string& filename) {
+    auto Compilations = defaultCompilations();
     if (!Compilations) {
+        AnalysisResult result;
         result.report = "Failed to create compilation database";
         return result;
     }
 
+    uint64_t hitsBefore = cacheHits();
+    uint64_t missesBefore = cacheMisses();
+    AnalysisResult result = analyzeWithDatabase(*Compilations, filename);
+    if (!result.success) {
+        return result;
+    }
+    std::vector<std::string> dotFailures = writeFunctionDots(result);
+
+    // Generate outputs
+    {
+        QMutexLocker locker(&m_analysisMutex);
+        result.metrics.linkCalls(result.functionDependencies);
+        result.graph = buildCallGraph(result);
+        result.report = generateReport(result) + cacheSummary(hitsBefore, missesBefore) +
+                        dotFailureSummary(dotFailures);
+    }
+
+    return result;
+}
+
+AnalysisResult CFGAnalyzer::analyzeWithDatabase(
+    const clang::tooling::CompilationDatabase& compilations,
+    const std::string& filename)
+{
+    AnalysisResult result;
+
+    // The cache key covers the exact command line and its directory, so the
+    // same file built with different flags or in another build tree gets its
+    // own entry.
+    SummaryCache* cache = m_impl->m_cache.get();
+    std::string flags;
+    std::string workingDirectory;
+    if (cache) {
+        for (const auto& command : compilations.getCompileCommands(filename)) {
+            workingDirectory = command.Directory;
+            flags += command.Directory;
+            flags += '\0';
+            for (const auto& arg : command.CommandLine) {
+                flags += arg;
+                flags += '\0';
+            }
+        }
+        // Entries written with per-function DOTs carry them, so a hit has to
+        // come from a run that produced them, with the same label mode.
+        if (m_options.emitFunctionDots) {
+            flags += "function-dots";
+            flags += '\0';
+        }
+        if (m_options.prettyPrintLabels) {
+            flags += "pretty-print-labels";
+            flags += '\0';
+        }
+        if (cache->lookup(filename, flags, result)) {
+            result.success = true;
+            return result;
+        }
+    }
+
+    // A filesystem per tool keeps the working directory private to this
+    // thread (the real filesystem would chdir() the whole process), while
+    // stats and header contents come from the process-wide cache.
     std::vector<std::string> Sources{filename};
-    clang::tooling::ClangTool Tool(*Compilations, Sources);
+    clang::tooling::ClangTool Tool(compilations, Sources,
+                                   std::make_shared<clang::PCHContainerOperations>(),
+                                   SharedFileCache::instance().createFileSystem());
 
     class CFGActionFactory : public clang::tooling::FrontendActionFactory {
     public:
-        CFGActionFactory(AnalysisResult& results) : m_results(results) {}
+        CFGActionFactory(AnalysisResult& results,
+                         std::shared_ptr<clang::DependencyCollector> dependencies,
+                         bool emitDots, bool prettyPrintLabels)
+            : m_results(results), m_dependencies(std::move(dependencies)), m_emitDots(emitDots),
+              m_prettyPrintLabels(prettyPrintLabels) {}
         
         std::unique_ptr<clang::FrontendAction> create() override {
-            std::string outputDir = "cfg_output";
-            return std::unique_ptr<CFGAction>(new CFGAction(outputDir, m_results));
+            return std::unique_ptr<CFGAction>(
+                new CFGAction(m_results, m_dependencies, m_emitDots, m_prettyPrintLabels));
         }
         
     private:
         AnalysisResult& m_results;
+        std::shared_ptr<clang::DependencyCollector> m_dependencies;
+        bool m_emitDots;
+        bool m_prettyPrintLabels;
     };
 
-    CFGActionFactory factory(result);
+    std::shared_ptr<TUDependencyCollector> dependencies;
+    if (cache) {
+        dependencies = std::make_shared<TUDependencyCollector>();
+    }
+
+    CFGActionFactory factory(result, dependencies, m_options.emitFunctionDots,
+                             m_options.prettyPrintLabels);
     int ToolResult = Tool.run(&factory);
     
     if (ToolResult != 0) {
@@ -344,17 +912,364 @@ AnalysisResult CFGAnalyzer::analyze(const std::string& filename) {
         return result;
     }
 
-    // Generate outputs
+    result.success = true;
+    // Callers already run translation units in parallel, so this one's
+    // CFGs are measured on the calling thread.
+    result.metrics.measure(1);
+
+    if (cache) {
+        // Dependency paths are spelled relative to the compile command's
+        // directory, which is not this process's working directory.
+        std::vector<std::string> dependencyPaths;
+        for (const auto& dependency : dependencies->getDependencies()) {
+            llvm::SmallString<256> path(dependency);
+            if (!workingDirectory.empty()) {
+                llvm::sys::fs::make_absolute(workingDirectory, path);
+            }
+            dependencyPaths.push_back(std::string(path.str()));
+        }
+        cache->store(filename, flags, dependencyPaths, result);
+    }
+
+    return result;
+}
+
+AnalysisResult CFGAnalyzer::analyzeInSession(const std::string& filename) {
+    AnalysisResult result;
+    unsigned errorCount = 0;
+
+    bool parsed = m_impl->m_session.withAST(filename, [&](clang::ASTUnit& unit) {
+        errorCount = unit.getDiagnostics().getNumErrors();
+        if (errorCount > 0) {
+            return;
+        }
+
+        // Only main-file top-level decls are walked; declarations living in
+        // the preamble stay unloaded.
+        clang::ASTContext& context = unit.getASTContext();
+        FunctionSnapshotMap& snapshots = m_impl->snapshotsFor(filename);
+        CFGVisitor visitor(&context, result);
+        visitor.setSnapshots(&snapshots);
+        visitor.setStringPool(m_impl->stringPool());
+        visitor.setPrettyPrintLabels(m_options.prettyPrintLabels);
+        visitor.setEmitDots(m_options.emitFunctionDots);
+        visitor.setBuildCFGs(!m_options.lazyFunctionCFGs);
+        for (auto it = unit.top_level_begin(); it != unit.top_level_end(); ++it) {
+            visitor.TraverseDecl(*it);
+        }
+        visitor.Finalize();
+
+        // Only rebuilt CFGs are pending; unchanged functions brought their
+        // metrics from the snapshots, which now keep the new ones too.
+        result.metrics.measure(m_options.jobs);
+        for (auto& [key, snapshot] : snapshots) {
+            if (snapshot.measured || snapshot.dot.empty()) continue;
+            uint32_t row = result.metrics.find(snapshot.symbol);
+            if (row != MetricsTable::npos) {
+                snapshot.metrics = result.metrics.row(row);
+                snapshot.measured = true;
+            }
+        }
+    });
+
+    if (!parsed) {
+        result.report = "Failed to parse: " + filename;
+        return result;
+    }
+    if (errorCount > 0) {
+        result.report = "Analysis failed with " + std::to_string(errorCount) + " error(s)";
+        return result;
+    }
+    std::vector<std::string> dotFailures = writeFunctionDots(result);
+
+    ASTSession::Timings timings = m_impl->m_session.timings(filename);
     {
         QMutexLocker locker(&m_analysisMutex);
-        result.dotOutput = generateDotOutput(result);
-        result.report = generateReport(result);
+        result.metrics.linkCalls(result.functionDependencies);
+        result.graph = buildCallGraph(result);
+
+        std::stringstream report;
+        report << generateReport(result)
+               << "Parse Timings:\n"
+               << "  First parse: " << std::fixed << std::setprecision(1)
+               << timings.firstParseMs << " ms\n";
+        if (timings.reparseCount > 0) {
+            report << "  Last reparse: " << timings.lastReparseMs << " ms"
+                   << " (" << timings.reparseCount << " reparse(s))\n";
+        }
+        report << "\nFunctions indexed: " << result.functions.size() << "\n"
+               << (m_options.lazyFunctionCFGs ? "Invalidated CFGs: " : "Rebuilt CFGs: ")
+               << result.changedFunctions.size() << "\n";
+        for (const auto& function : result.changedFunctions) {
+            report << "  - " << function << "\n";
+        }
+        report << graphArenaSummary(result.arenaStats)
+               << dotFailureSummary(dotFailures);
+        result.report = report.str();
         result.success = true;
     }
 
     return result;
 }
 
+AnalysisResult CFGAnalyzer::analyzeFunction(const std::string& filename,
+                                            const std::string& functionName)
+{
+    AnalysisResult result;
+    unsigned errorCount = 0;
+
+    // The index pass already parsed this file; reuse its AST as is so that
+    // opening a function never costs a reparse.
+    bool parsed = m_impl->m_session.withAST(filename, [&](clang::ASTUnit& unit) {
+        errorCount = unit.getDiagnostics().getNumErrors();
+        if (errorCount > 0) {
+            return;
+        }
+
+        clang::ASTContext& context = unit.getASTContext();
+        CFGVisitor visitor(&context, result);
+        visitor.setSnapshots(&m_impl->snapshotsFor(filename));
+        visitor.setStringPool(m_impl->stringPool());
+        visitor.setPrettyPrintLabels(m_options.prettyPrintLabels);
+        visitor.setTargetFunction(functionName);
+        for (auto it = unit.top_level_begin(); it != unit.top_level_end(); ++it) {
+            if (!visitor.TraverseDecl(*it)) {
+                break;
+            }
+        }
+    }, /*reparse=*/false);
+
+    if (!parsed) {
+        result.report = "Failed to parse: " + filename;
+        return result;
+    }
+    if (errorCount > 0) {
+        result.report = "Analysis failed with " + std::to_string(errorCount) + " error(s)";
+        return result;
+    }
+    if (!result.graph) {
+        result.report = "No CFG for function: " + functionName;
+        return result;
+    }
+
+    result.report = "CFG of " + functionName +
+                    (result.changedFunctions.empty() ? " (cached)\n" : " (built)\n");
+    result.success = true;
+    return result;
+}
+
+AnalysisResult CFGAnalyzer::analyzeFunction(const clang::tooling::CompileCommand& command,
+                                            const std::string& functionName)
+{
+    AnalysisResult result;
+
+    // loadUnit adds the driver name and the file itself; relative paths in
+    // the command are resolved against its directory.
+    clang::tooling::CommandLineArguments args = clang::tooling::getClangSyntaxOnlyAdjuster()(
+        command.CommandLine, command.Filename);
+    args = clang::tooling::getClangStripOutputAdjuster()(args, command.Filename);
+    std::vector<std::string> compileArgs{"-working-directory", command.Directory};
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] != command.Filename) {
+            compileArgs.push_back(args[i]);
+        }
+    }
+
+    std::unique_ptr<clang::ASTUnit> unit = ASTSession::loadUnit(command.Filename, compileArgs);
+    if (!unit) {
+        result.report = "Failed to parse: " + command.Filename;
+        return result;
+    }
+    unsigned errorCount = unit->getDiagnostics().getNumErrors();
+    if (errorCount > 0) {
+        result.report = "Analysis failed with " + std::to_string(errorCount) + " error(s)";
+        return result;
+    }
+
+    CFGVisitor visitor(&unit->getASTContext(), result);
+    visitor.setStringPool(m_impl->stringPool());
+    visitor.setPrettyPrintLabels(m_options.prettyPrintLabels);
+    visitor.setTargetFunction(functionName);
+    visitor.TraverseDecl(unit->getASTContext().getTranslationUnitDecl());
+    if (!result.graph) {
+        result.report = "No CFG for function: " + functionName;
+        return result;
+    }
+
+    result.report = "CFG of " + functionName + " (built)\n";
+    result.success = true;
+    return result;
+}
+
+void CFGAnalyzer::setUnsavedBuffer(const std::string& filename, const std::string& contents) {
+    m_impl->m_session.setUnsavedBuffer(filename, contents);
+}
+
+void CFGAnalyzer::clearUnsavedBuffer(const std::string& filename) {
+    m_impl->m_session.clearUnsavedBuffer(filename);
+}
+
+ASTSession::Timings CFGAnalyzer::parseTimings(const std::string& filename) const {
+    return m_impl->m_session.timings(filename);
+}
+
+void CFGAnalyzer::mergeResult(AnalysisResult& target, AnalysisResult&& source) {
+    mergeCallGraph(target.functionDependencies, std::move(source.functionDependencies));
+    target.functions.merge(source.functions);
+    target.metrics.merge(std::move(source.metrics));
+    // Like functions, the first unit to define a name keeps its CFG.
+    target.functionDots.merge(source.functionDots);
+    target.arenaStats += source.arenaStats;
+}
+
+std::vector<std::string> CFGAnalyzer::writeFunctionDots(AnalysisResult& result) const {
+    std::vector<std::string> failed;
+    if (result.functionDots.empty() || !m_options.emitFunctionDots) {
+        result.functionDots.clear();
+        return failed;
+    }
+    if (llvm::sys::fs::create_directories(m_options.outputDir)) {
+        failed.push_back(m_options.outputDir);
+        result.functionDots.clear();
+        return failed;
+    }
+    for (const auto& [name, dot] : result.functionDots) {
+        llvm::SmallString<256> path(m_options.outputDir);
+        llvm::sys::path::append(path, name + "_cfg.dot");
+        std::ofstream outFile(std::string(path.str()));
+        outFile << dot;
+        outFile.close();
+        if (!outFile) {
+            failed.push_back(std::string(path.str()));
+        }
+    }
+    result.functionDots.clear();
+    return failed;
+}
+
+std::shared_ptr<const GraphGenerator::FrozenGraph> CFGAnalyzer::buildCallGraph(const AnalysisResult& result) {
+    auto graph = std::make_unique<GraphGenerator::CFGGraph>();
+
+    // Node ids follow caller name order, so the same project always gets
+    // the same ids whatever SymbolIds this process handed out.
+    SymbolNames names(result.functionDependencies);
+    std::unordered_map<SymbolId, int> ids;
+    auto nodeFor = [&](SymbolId symbol) {
+        auto [it, inserted] = ids.emplace(symbol, static_cast<int>(ids.size()) + 1);
+        if (inserted) {
+            const std::string& name = SymbolTable::instance().symbol(symbol).name;
+            QString functionName = QString::fromStdString(names[symbol]);
+            graph->addNode(it->second, functionName);
+            graph->setNodeFunctionName(it->second, QString::fromStdString(name));
+            auto info = result.functions.find(name);
+            if (info != result.functions.end()) {
+                graph->setNodeSourceLocation(it->second,
+                                             QString::fromStdString(info->second.filename),
+                                             static_cast<int>(info->second.line),
+                                             static_cast<int>(info->second.endLine));
+            }
+        }
+        return it->second;
+    };
+
+    for (const auto* entry : names.sortedCallers()) {
+        int caller = nodeFor(entry->first);
+        for (SymbolId callee : names.sorted(entry->second)) {
+            graph->addEdge(caller, nodeFor(callee));
+        }
+    }
+    return graph->freeze();
+}
+
+AnalysisResult CFGAnalyzer::analyzeProject(
+    const std::string& buildPath,
+    std::function<bool(int, int)> progressCallback)
+{
+    AnalysisResult result;
+
+    std::string errorMessage;
+    auto compilations = loadCompilations(buildPath, errorMessage);
+    if (!compilations) {
+        result.report = "Failed to load compilation database: " + errorMessage;
+        return result;
+    }
+
+    std::vector<std::string> files = compilations->getAllFiles();
+    std::sort(files.begin(), files.end());
+    if (files.empty()) {
+        result.report = "Compilation database contains no translation units";
+        return result;
+    }
+
+    if (progressCallback && !progressCallback(0, static_cast<int>(files.size()))) {
+        result.report = "Analysis canceled by user";
+        return result;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    uint64_t hitsBefore = cacheHits();
+    uint64_t missesBefore = cacheMisses();
+    SharedFileCache::Stats fileCacheBefore = SharedFileCache::instance().stats();
+
+    // Each worker runs its own ClangTool, and therefore its own
+    // CompilerInstance, writing into a private slot of partials.
+    int processedUnits = 0;
+    std::vector<AnalysisResult> partials(files.size());
+    WorkerPool pool(m_options.jobs);
+    bool completed = pool.run(files.size(),
+        [&](size_t index) {
+            partials[index] = analyzeWithDatabase(*compilations, files[index]);
+        },
+        [&](size_t) {
+            ++processedUnits;
+            return !progressCallback ||
+                   progressCallback(processedUnits, static_cast<int>(files.size()));
+        });
+
+    if (!completed) {
+        result.report = "Analysis canceled by user";
+        return result;
+    }
+
+    size_t failedUnits = 0;
+    for (size_t i = 0; i < partials.size(); ++i) {
+        if (!partials[i].success) {
+            ++failedUnits;
+            result.arenaStats += partials[i].arenaStats;
+            continue;
+        }
+        mergeResult(result, std::move(partials[i]));
+    }
+    std::vector<std::string> dotFailures = writeFunctionDots(result);
+
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    result.success = failedUnits < files.size();
+    {
+        QMutexLocker locker(&m_analysisMutex);
+        result.metrics.linkCalls(result.functionDependencies);
+        result.graph = buildCallGraph(result);
+
+        std::stringstream report;
+        report << "Project Analysis Report\n"
+               << "=======================\n\n"
+               << "Compilation database: " << buildPath << "\n"
+               << "Translation units: " << files.size() << "\n"
+               << "Failed translation units: " << failedUnits << "\n"
+               << "Worker threads: " << pool.jobs() << "\n"
+               << "Wall time: " << elapsedMs << " ms\n"
+               << cacheSummary(hitsBefore, missesBefore)
+               << fileCacheSummary(fileCacheBefore)
+               << graphArenaSummary(result.arenaStats)
+               << dotFailureSummary(dotFailures) << "\n"
+               << generateReport(result);
+        result.report = report.str();
+    }
+
+    return result;
+}
+
 AnalysisResult CFGAnalyzer::analyzeMultipleFiles(
     const std::vector<std::string>& files,
     std::function<bool(int, int)> progressCallback)
@@ -371,84 +1286,79 @@ AnalysisResult CFGAnalyzer::analyzeMultipleFiles(
         // Progress tracking
         int totalFiles = files.size();
         int processedFiles = 0;
-        
-        // Combined data structures
-        std::unordered_map<std::string, std::set<std::string>> combinedDependencies;
-        std::stringstream combinedDotStream;
-        
-        combinedDotStream << "digraph MultiFileCFG {\n"
-                         << "  rankdir=TB;\n"
-                         << "  node [shape=rectangle, style=filled, fillcolor=lightgray];\n"
-                         << "  edge [arrowsize=0.8];\n\n";
-                         
-        std::set<std::string> allFunctions;
-        
-        // Process each file
-        for (const auto& file : files) {
-            if (progressCallback && !progressCallback(processedFiles++, totalFiles)) {
-                result.report = "Analysis canceled by user";
-                return result;
-            }
-            
-            // Analyze individual file
-            AnalysisResult fileResult = analyze(file);
-            if (!fileResult.success) {
-                continue;
-            }
-            
-            // Merge function dependencies
-            for (const auto& [func, deps] : fileResult.functionDependencies) {
-                if (combinedDependencies.find(func) != combinedDependencies.end()) {
-                    combinedDependencies[func].insert(deps.begin(), deps.end());
-                } else {
-                    combinedDependencies[func] = deps;
-                }
-                
-                // Track function names
-                allFunctions.insert(func);
-                allFunctions.insert(deps.begin(), deps.end());
-            }
+
+        if (progressCallback && !progressCallback(processedFiles, totalFiles)) {
+            result.report = "Analysis canceled by user";
+            return result;
         }
         
-        // Generate nodes for all functions
-        for (const auto& func : allFunctions) {
-            std::string fillColor = "lightblue";
-            
-            combinedDotStream << "  \"" << func << "\" ["
-                             << "shape=box, "
-                             << "style=filled, "
-                             << "fillcolor=\"" << fillColor << "\""
-                             << "];\n";
+        // Each file writes only into its own slot; the reduction below runs in
+        // file order so the output does not depend on the thread count.
+        auto compilations = defaultCompilations();
+        uint64_t hitsBefore = cacheHits();
+        uint64_t missesBefore = cacheMisses();
+        SharedFileCache::Stats fileCacheBefore = SharedFileCache::instance().stats();
+        std::vector<AnalysisResult> partials(files.size());
+        WorkerPool pool(m_options.jobs);
+        bool completed = pool.run(files.size(),
+            [&](size_t index) {
+                partials[index] = analyzeWithDatabase(*compilations, files[index]);
+            },
+            [&](size_t) {
+                ++processedFiles;
+                return !progressCallback || progressCallback(processedFiles, totalFiles);
+            });
+
+        if (!completed) {
+            result.report = "Analysis canceled by user";
+            return result;
         }
         
-        // Generate edges
-        for (const auto& [caller, callees] : combinedDependencies) {
-            for (const auto& callee : callees) {
-                combinedDotStream << "  \"" << caller << "\" -> \""
-                                 << callee << "\";\n";
+        std::vector<std::string> failures;
+        for (size_t i = 0; i < partials.size(); ++i) {
+            if (!partials[i].success) {
+                failures.push_back(files[i] + ": " + partials[i].report);
+                result.arenaStats += partials[i].arenaStats;
+                continue;
             }
+            mergeResult(result, std::move(partials[i]));
         }
+        std::vector<std::string> dotFailures = writeFunctionDots(result);
+        const auto& combinedDependencies = result.functionDependencies;
         
-        combinedDotStream << "}\n";
+        SymbolNames names(combinedDependencies);
         
         // Set up result
-        result.success = true;
-        result.functionDependencies = combinedDependencies;
-        result.dotOutput = combinedDotStream.str();
+        result.success = failures.size() < files.size();
+        result.metrics.linkCalls(combinedDependencies);
+        result.graph = buildCallGraph(result);
         
         // Generate report
         std::stringstream reportStream;
         reportStream << "Multi-file Analysis Report\n"
                     << "========================\n\n"
                     << "Files analyzed: " << files.size() << "\n"
-                    << "Functions found: " << allFunctions.size() << "\n"
-                    << "Function calls: " << countFunctionCalls(combinedDependencies) << "\n\n"
-                    << "Function Dependencies:\n";
+                    << "Failed files: " << failures.size() << "\n"
+                    << "Functions found: " << names.symbols().size() << "\n"
+                    << "Function calls: " << countFunctionCalls(combinedDependencies) << "\n"
+                    << cacheSummary(hitsBefore, missesBefore)
+                    << fileCacheSummary(fileCacheBefore)
+                    << graphArenaSummary(result.arenaStats)
+                    << dotFailureSummary(dotFailures)
+                    << componentSummary(result.graph.get())
+                    << metricsSummary(result.metrics) << "\n";
+        for (const auto& failure : failures) {
+            reportStream << "FAILED " << failure << "\n";
+        }
+        if (!failures.empty()) {
+            reportStream << "\n";
+        }
+        reportStream << "Function Dependencies:\n";
                     
-        for (const auto& [caller, callees] : combinedDependencies) {
-            reportStream << caller << " calls:\n";
-            for (const auto& callee : callees) {
-                reportStream << "  - " << callee << "\n";
+        for (const auto* entry : names.sortedCallers()) {
+            reportStream << names[entry->first] << " calls:\n";
+            for (SymbolId callee : names.sorted(entry->second)) {
+                reportStream << "  - " << names[callee] << "\n";
             }
             reportStream << "\n";
         }
@@ -462,7 +1372,7 @@ AnalysisResult CFGAnalyzer::analyzeMultipleFiles(
     return result;
 }
 
-int CFGAnalyzer::countFunctionCalls(const std::unordered_map<std::string, std::set<std::string>>& dependencies) const {
+int CFGAnalyzer::countFunctionCalls(const CallGraph& dependencies) const {
     int count = 0;
     for (const auto& [_, callees] : dependencies) {
         count += callees.size();
@@ -477,10 +1387,12 @@ std::string CFGAnalyzer::generateDotOutput(const AnalysisResult& result) const {
               << "  edge [arrowsize=0.8];\n"
               << "  rankdir=LR;\n\n";
 
-    for (const auto& [caller, callees] : result.functionDependencies) {
+    SymbolNames names(result.functionDependencies);
+    for (const auto* entry : names.sortedCallers()) {
+        const std::string& caller = names[entry->first];
         dotStream << "  \"" << caller << "\";\n";
-        for (const auto& callee : callees) {
-            dotStream << "  \"" << caller << "\" -> \"" << callee << "\";\n";
+        for (SymbolId callee : names.sorted(entry->second)) {
+            dotStream << "  \"" << caller << "\" -> \"" << names[callee] << "\";\n";
         }
     }
 
@@ -492,7 +1404,7 @@ AnalysisResult CFGAnalyzer::analyzeFile(const QString& filePath) {
     AnalysisResult result;
     try {
         std::string filename = filePath.toStdString();
-        result = analyze(filename);
+        result = analyzeInSession(filename);
         
         if (!result.success) {
             return result;
@@ -503,9 +1415,14 @@ AnalysisResult CFGAnalyzer::analyzeFile(const QString& filePath) {
         j["timestamp"] = getCurrentDateTime();
         j["functions"] = json::array();
         
-        for (const auto& [func, calls] : result.functionDependencies) {
+        SymbolNames names(result.functionDependencies);
+        for (const auto* entry : names.sortedCallers()) {
+            json calls = json::array();
+            for (SymbolId callee : names.sorted(entry->second)) {
+                calls.push_back(names[callee]);
+            }
             json function;
-            function["name"] = func;
+            function["name"] = names[entry->first];
             function["calls"] = calls;
             j["functions"].push_back(function);
         }
@@ -538,13 +1455,16 @@ std::string CFGAnalyzer::generateReport(const AnalysisResult& result) const {
     report << "Generated: " << getCurrentDateTime() << "\n\n";
     report << "Function Dependencies:\n";
     
-    for (const auto& [caller, callees] : result.functionDependencies) {
-        report << caller << " calls:\n";
-        for (const auto& callee : callees) {
-            report << "  - " << callee << "\n";
+    SymbolNames names(result.functionDependencies);
+    for (const auto* entry : names.sortedCallers()) {
+        report << names[entry->first] << " calls:\n";
+        for (SymbolId callee : names.sorted(entry->second)) {
+            report << "  - " << names[callee] << "\n";
         }
         report << "\n";
     }
+    report << componentSummary(result.graph.get());
+    report << metricsSummary(result.metrics);
     
     return report.str();
 }
@@ -558,59 +1478,9 @@ AnalysisResult CFGAnalyzer::analyzeFiles(const std::vector<std::string>& filePat
         return analyzeFile(QString::fromStdString(filePaths[0]));
     }
     
-    std::string combinedReport = "Multi-file Analysis Results:\n\n";
-    std::string combinedDot = "digraph G {\n";
-    bool anySuccess = false;
-    
-    for (const auto& filePath : filePaths) {
-        auto result = analyzeFile(QString::fromStdString(filePath));
-        combinedReport += "=== File: " + filePath + " ===\n";
-        
-        if (result.success) {
-            std::string filteredDot = filterDotOutput(result.dotOutput);
-            
-            combinedDot += "subgraph \"" + filePath + "\" {\n";
-            combinedDot += filteredDot;
-            combinedDot += "}\n\n";
-            
-            combinedReport += result.report + "\n\n";
-            anySuccess = true;
-        } else {
-            combinedReport += "Analysis failed: " + result.report + "\n\n";
-        }
-    }
-    
-    combinedDot += "}\n";
-    
-    return AnalysisResult(
-        anySuccess,
-        anySuccess ? combinedDot : "",
-        combinedReport
-    );
-}
-
-std::string CFGAnalyzer::filterDotOutput(const std::string& dotContent) {
-    std::string filtered;
-    std::istringstream stream(dotContent);
-    std::string line;
-    bool inContent = false;
-    
-    while (std::getline(stream, line)) {
-        // Skip header and footer lines
-        if (line.find("digraph") != std::string::npos) {
-            inContent = true;
-            continue;
-        }
-        if (line == "}" && inContent) {
-            break;
-        }
-        
-        if (inContent && !line.empty()) {
-            filtered += line + "\n";
-        }
-    }
-    
-    return filtered;
+    // Batches share the worker pool, summary cache and in-order merge of
+    // analyzeMultipleFiles, so the result does not depend on the job count.
+    return analyzeMultipleFiles(filePaths);
 }
 
 }
\ No newline at end of file
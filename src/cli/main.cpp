@@ -0,0 +1,297 @@
+// cfgparser-cli: headless batch front end. Links the analysis core and
+// QtCore only, so it starts without a display or WebEngine.
+#include "cfg_analyzer.h"
+#include "analysis_codec.h"
+#include "frozen_graph.h"
+#include "graph_arena.h"
+#include "shared_file_cache.h"
+#include "worker_pool.h"
+#include <clang/Tooling/CompilationDatabase.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include <nlohmann/json.hpp>
+#include <QString>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+namespace cl = llvm::cl;
+
+enum class OutputFormat { Dot, Json, Binary };
+
+cl::OptionCategory CliCategory("cfgparser-cli options");
+
+cl::list<std::string> InputFiles(cl::Positional, cl::desc("[<source>...]"),
+                                 cl::cat(CliCategory));
+
+cl::opt<std::string> BuildPath("p", cl::desc("Build directory or compile_commands.json; "
+                                             "without sources, analyzes every TU in it"),
+                               cl::value_desc("path"), cl::cat(CliCategory));
+
+cl::opt<unsigned> Jobs("j", cl::desc("Worker threads (default: hardware threads)"),
+                       cl::init(0), cl::cat(CliCategory));
+
+cl::opt<std::string> OutputDir("o", cl::desc("Output directory"), cl::value_desc("dir"),
+                               cl::init("cfg_output"), cl::cat(CliCategory));
+
+cl::list<OutputFormat> Formats(
+    "format", cl::desc("Output formats (comma separated, default: dot)"), cl::CommaSeparated,
+    cl::values(clEnumValN(OutputFormat::Dot, "dot", "Call graph as DOT"),
+               clEnumValN(OutputFormat::Json, "json", "Functions and calls as JSON"),
+               clEnumValN(OutputFormat::Binary, "binary", "AnalysisCodec-encoded result")),
+    cl::cat(CliCategory));
+
+cl::list<std::string> Functions("function", cl::desc("Also write the CFG of this function"),
+                                cl::value_desc("name"), cl::cat(CliCategory));
+
+cl::opt<bool> FunctionDots("function-dots",
+                           cl::desc("Write <function>_cfg.dot for every analyzed function "
+                                    "(off: CFGs are only measured)"),
+                           cl::cat(CliCategory));
+
+cl::opt<std::string> CacheDir("cache-dir", cl::desc("Persistent per-TU summary cache"),
+                              cl::value_desc("dir"), cl::cat(CliCategory));
+
+cl::opt<bool> PrettyPrintLabels("pretty-print-labels",
+                                cl::desc("Pretty-print every CFG statement instead of "
+                                         "quoting its source text"),
+                                cl::cat(CliCategory));
+
+cl::opt<bool> Stats("stats", cl::desc("Print timing statistics to stderr"),
+                    cl::cat(CliCategory));
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool writeFile(const std::string& path, const char* data, size_t size) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(data, size);
+    if (!out) {
+        llvm::errs() << "error: cannot write " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+std::string outputPath(const std::string& name) {
+    llvm::SmallString<256> path(OutputDir);
+    llvm::sys::path::append(path, name);
+    return std::string(path.str());
+}
+
+std::string toJson(const CFGAnalyzer::AnalysisResult& result) {
+    using json = nlohmann::json;
+    // Overloads are separate symbols but share a functions entry, so their
+    // calls are listed together under the qualified name.
+    CFGAnalyzer::SymbolNames names(result.functionDependencies);
+    std::map<std::string, std::set<std::string>> callsByName;
+    for (const auto* entry : names.sortedCallers()) {
+        auto& calls = callsByName[CFGAnalyzer::SymbolTable::instance().symbol(entry->first).name];
+        for (CFGAnalyzer::SymbolId callee : names.sorted(entry->second)) {
+            calls.insert(names[callee]);
+        }
+    }
+
+    json j;
+    j["functions"] = json::array();
+    for (const auto& [name, info] : result.functions) {
+        json function;
+        function["name"] = name;
+        function["file"] = info.filename;
+        function["line"] = info.line;
+        function["endLine"] = info.endLine;
+        auto calls = callsByName.find(name);
+        function["calls"] = calls != callsByName.end() ? json(calls->second) : json::array();
+        j["functions"].push_back(function);
+    }
+    return j.dump(2);
+}
+
+// Function names may contain "::" and operator punctuation.
+std::string fileNameFor(const std::string& functionName) {
+    std::string name = functionName;
+    for (char& c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') {
+            c = '_';
+        }
+    }
+    return name + ".dot";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    cl::HideUnrelatedOptions(CliCategory);
+    cl::ParseCommandLineOptions(argc, argv,
+        "Builds function-call graphs and CFGs of C/C++ sources without the GUI.\n");
+
+    auto startTime = Clock::now();
+
+    std::unique_ptr<clang::tooling::CompilationDatabase> compilations;
+    if (!BuildPath.empty()) {
+        std::string errorMessage;
+        compilations = CFGAnalyzer::CFGAnalyzer::loadCompilations(BuildPath, errorMessage);
+        if (!compilations) {
+            llvm::errs() << "error: failed to load compilation database: " << errorMessage << "\n";
+            return 2;
+        }
+    } else {
+        compilations = CFGAnalyzer::CFGAnalyzer::defaultCompilations();
+    }
+
+    std::vector<std::string> files(InputFiles.begin(), InputFiles.end());
+    if (files.empty() && !BuildPath.empty()) {
+        files = compilations->getAllFiles();
+        std::sort(files.begin(), files.end());
+    }
+    if (files.empty()) {
+        llvm::errs() << "error: no input files (pass sources or -p <build dir>)\n";
+        return 2;
+    }
+
+    if (std::error_code ec = llvm::sys::fs::create_directories(OutputDir)) {
+        llvm::errs() << "error: cannot create " << OutputDir << ": " << ec.message() << "\n";
+        return 2;
+    }
+
+    CFGAnalyzer::AnalysisOptions options;
+    options.jobs = Jobs;
+    options.cacheDir = CacheDir;
+    options.prettyPrintLabels = PrettyPrintLabels;
+    options.outputDir = OutputDir;
+    options.emitFunctionDots = FunctionDots;
+    CFGAnalyzer::CFGAnalyzer analyzer;
+    analyzer.setOptions(options);
+
+    // Same scheduling as CFGAnalyzer::analyzeProject, with per-TU timings.
+    auto analysisStart = Clock::now();
+    std::vector<CFGAnalyzer::AnalysisResult> partials(files.size());
+    std::vector<double> unitMs(files.size());
+    CFGAnalyzer::WorkerPool pool(Jobs);
+    pool.run(files.size(), [&](size_t index) {
+        auto unitStart = Clock::now();
+        partials[index] = analyzer.analyzeWithDatabase(*compilations, files[index]);
+        unitMs[index] = millisecondsSince(unitStart);
+    });
+    double analysisMs = millisecondsSince(analysisStart);
+
+    CFGAnalyzer::AnalysisResult result;
+    size_t failedUnits = 0;
+    // Unit each function was merged from, so --function reparses it with
+    // that unit's command line.
+    std::map<std::string, size_t> unitOf;
+    for (size_t i = 0; i < partials.size(); ++i) {
+        if (!partials[i].success) {
+            ++failedUnits;
+            llvm::errs() << "error: " << files[i] << ": " << partials[i].report << "\n";
+            result.arenaStats += partials[i].arenaStats;
+            continue;
+        }
+        for (const auto& entry : partials[i].functions) {
+            unitOf.emplace(entry.first, i);
+        }
+        CFGAnalyzer::CFGAnalyzer::mergeResult(result, std::move(partials[i]));
+    }
+    result.success = failedUnits < files.size();
+    result.metrics.linkCalls(result.functionDependencies);
+    bool written = true;
+    for (const auto& path : analyzer.writeFunctionDots(result)) {
+        llvm::errs() << "error: cannot write " << path << "\n";
+        written = false;
+    }
+    std::vector<OutputFormat> formats(Formats.begin(), Formats.end());
+    if (formats.empty()) {
+        formats.push_back(OutputFormat::Dot);
+    }
+    for (OutputFormat format : formats) {
+        switch (format) {
+        case OutputFormat::Dot: {
+            std::string dot = analyzer.generateDotOutput(result);
+            written &= writeFile(outputPath("call_graph.dot"), dot.data(), dot.size());
+            break;
+        }
+        case OutputFormat::Json: {
+            std::string json = toJson(result);
+            written &= writeFile(outputPath("call_graph.json"), json.data(), json.size());
+            break;
+        }
+        case OutputFormat::Binary: {
+            QByteArray data = CFGAnalyzer::AnalysisCodec::encode(result);
+            written &= writeFile(outputPath("analysis.cfgr"), data.constData(), data.size());
+            break;
+        }
+        }
+    }
+
+    // Each requested CFG is rebuilt with the same command line its unit was
+    // analyzed with.
+    size_t missingFunctions = 0;
+    for (const auto& name : Functions) {
+        auto it = unitOf.find(name);
+        if (it == unitOf.end()) {
+            llvm::errs() << "error: function not found: " << name << "\n";
+            ++missingFunctions;
+            continue;
+        }
+        auto commands = compilations->getCompileCommands(files[it->second]);
+        if (commands.empty()) {
+            llvm::errs() << "error: no compile command for " << files[it->second] << "\n";
+            ++missingFunctions;
+            continue;
+        }
+        auto cfg = analyzer.analyzeFunction(commands.front(), name);
+        result.arenaStats += cfg.arenaStats;
+        if (!cfg.success) {
+            llvm::errs() << "error: " << cfg.report;
+            ++missingFunctions;
+            continue;
+        }
+        std::string dot = cfg.graph->toDot();
+        written &= writeFile(outputPath(fileNameFor(name)), dot.data(), dot.size());
+    }
+
+    if (Stats) {
+        std::vector<size_t> slowest(files.size());
+        for (size_t i = 0; i < slowest.size(); ++i) slowest[i] = i;
+        size_t shown = std::min<size_t>(5, slowest.size());
+        std::partial_sort(slowest.begin(), slowest.begin() + shown, slowest.end(),
+                          [&](size_t a, size_t b) { return unitMs[a] > unitMs[b]; });
+
+        CFGAnalyzer::SharedFileCache::Stats fileStats = CFGAnalyzer::SharedFileCache::instance().stats();
+        const GraphGenerator::GraphArena::Stats& arenaStats = result.arenaStats;
+        llvm::raw_ostream& err = llvm::errs();
+        err << "Translation units: " << files.size() << " (" << failedUnits << " failed)\n"
+            << "Functions: " << result.functions.size() << "\n"
+            << "Worker threads: " << pool.jobs() << "\n"
+            << "Analysis time: " << llvm::format("%.1f", analysisMs) << " ms ("
+            << llvm::format("%.1f", files.size() * 1000.0 / std::max(analysisMs, 1.0)) << " TU/s)\n"
+            << "Total time: " << llvm::format("%.1f", millisecondsSince(startTime)) << " ms\n"
+            << "File cache: " << fileStats.statHits << " stat hits, " << fileStats.statMisses
+            << " misses; " << fileStats.readHits << " read hits, " << fileStats.readMisses
+            << " misses\n"
+            << "Graph allocations: " << arenaStats.allocations
+            << " served from " << arenaStats.blocks << " arena blocks ("
+            << arenaStats.bytes / 1024 << " KiB)\n"
+            << "Slowest translation units:\n";
+        for (size_t i = 0; i < shown; ++i) {
+            err << "  " << llvm::format("%8.1f", unitMs[slowest[i]]) << " ms  "
+                << files[slowest[i]] << "\n";
+        }
+    }
+
+    return (failedUnits == 0 && missingFunctions == 0 && written) ? 0 : 1;
+}
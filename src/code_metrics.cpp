@@ -0,0 +1,203 @@
+#include "code_metrics.h"
+#include "frozen_graph.h"
+#include "graph_analysis.h"
+#include "worker_pool.h"
+#include <algorithm>
+
+namespace CFGAnalyzer {
+
+namespace {
+
+// Columns measure() owns; the rest come from the caller or linkCalls().
+constexpr Metric CFGMetrics[] = {
+    Metric::Cyclomatic, Metric::Nesting, Metric::Blocks, Metric::ExceptionEdges
+};
+
+// CFGs measured per pool task; most functions are a handful of blocks.
+constexpr size_t MeasureBatch = 256;
+
+} // namespace
+
+const char* metricName(Metric metric) {
+    switch (metric) {
+    case Metric::Cyclomatic: return "Cyclomatic";
+    case Metric::Nesting: return "Nesting";
+    case Metric::Blocks: return "Blocks";
+    case Metric::Statements: return "Statements";
+    case Metric::FanIn: return "Fan-in";
+    case Metric::FanOut: return "Fan-out";
+    case Metric::ExceptionEdges: return "Exception edges";
+    case Metric::Count: break;
+    }
+    return "";
+}
+
+FunctionMetrics measureCFG(const GraphGenerator::FrozenGraph& cfg) {
+    FunctionMetrics metrics;
+    int64_t nodes = static_cast<int64_t>(cfg.nodeCount());
+    int64_t edges = static_cast<int64_t>(cfg.edgeCount());
+    // Unreachable blocks can push E - N + 2 below one path.
+    metrics[Metric::Cyclomatic] = static_cast<uint32_t>(std::max<int64_t>(1, edges - nodes + 2));
+    metrics[Metric::Blocks] = static_cast<uint32_t>(nodes);
+
+    uint32_t exceptionEdges = 0;
+    for (uint32_t edge = 0; edge < cfg.edgeCount(); ++edge) {
+        if (cfg.edgeFlags(edge) & GraphGenerator::ExceptionEdge) {
+            ++exceptionEdges;
+        }
+    }
+    metrics[Metric::ExceptionEdges] = exceptionEdges;
+
+    const GraphGenerator::RegionForest& regions = cfg.regions();
+    uint32_t nesting = 0;
+    for (uint32_t r = 0; r < regions.size(); ++r) {
+        nesting = std::max(nesting, regions[r].depth + 1);
+    }
+    metrics[Metric::Nesting] = nesting;
+    return metrics;
+}
+
+FunctionMetrics MetricsTable::row(uint32_t row) const {
+    FunctionMetrics metrics;
+    for (size_t m = 0; m < MetricCount; ++m) {
+        metrics.values[m] = m_columns[m][row];
+    }
+    return metrics;
+}
+
+uint32_t MetricsTable::find(SymbolId symbol) const {
+    auto it = m_rows.find(symbol);
+    return it == m_rows.end() ? npos : it->second;
+}
+
+uint32_t MetricsTable::rowFor(SymbolId symbol) {
+    auto [it, inserted] = m_rows.emplace(symbol, static_cast<uint32_t>(m_symbols.size()));
+    if (inserted) {
+        m_symbols.push_back(symbol);
+        m_names.push_back(SymbolTable::instance().symbol(symbol).name);
+        for (auto& column : m_columns) {
+            column.push_back(0);
+        }
+    } else if (!m_pending.empty()) {
+        uint32_t row = it->second;
+        m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+                                       [row](const auto& entry) { return entry.first == row; }),
+                        m_pending.end());
+    }
+    return it->second;
+}
+
+void MetricsTable::set(SymbolId symbol, const FunctionMetrics& metrics,
+                       std::shared_ptr<const GraphGenerator::FrozenGraph> cfg) {
+    uint32_t row = rowFor(symbol);
+    for (size_t m = 0; m < MetricCount; ++m) {
+        m_columns[m][row] = metrics.values[m];
+    }
+    if (cfg) {
+        m_pending.emplace_back(row, std::move(cfg));
+    }
+}
+
+void MetricsTable::merge(MetricsTable&& other) {
+    if (empty()) {
+        *this = std::move(other);
+        return;
+    }
+    std::vector<uint32_t> moved(other.size(), npos);
+    for (uint32_t source = 0; source < other.size(); ++source) {
+        auto [it, inserted] = m_rows.emplace(other.m_symbols[source], static_cast<uint32_t>(m_symbols.size()));
+        if (!inserted) continue;
+        moved[source] = it->second;
+        m_symbols.push_back(other.m_symbols[source]);
+        m_names.push_back(std::move(other.m_names[source]));
+        for (size_t m = 0; m < MetricCount; ++m) {
+            m_columns[m].push_back(other.m_columns[m][source]);
+        }
+    }
+    for (auto& [row, cfg] : other.m_pending) {
+        if (moved[row] != npos) {
+            m_pending.emplace_back(moved[row], std::move(cfg));
+        }
+    }
+    other = MetricsTable();
+}
+
+void MetricsTable::measure(unsigned jobs) {
+    if (m_pending.empty()) return;
+
+    // Every pending entry owns a distinct row, so workers write disjoint
+    // column slots. Region forests already built for the DOT output are
+    // cached on the graph and reused here.
+    size_t batches = (m_pending.size() + MeasureBatch - 1) / MeasureBatch;
+    WorkerPool pool(jobs);
+    pool.run(batches, [this](size_t batch) {
+        size_t end = std::min(m_pending.size(), (batch + 1) * MeasureBatch);
+        for (size_t i = batch * MeasureBatch; i < end; ++i) {
+            const auto& [row, cfg] = m_pending[i];
+            FunctionMetrics metrics = measureCFG(*cfg);
+            for (Metric metric : CFGMetrics) {
+                m_columns[static_cast<size_t>(metric)][row] = metrics[metric];
+            }
+        }
+    });
+    m_pending.clear();
+}
+
+void MetricsTable::linkCalls(const CallGraph& calls) {
+    auto& fanIn = m_columns[static_cast<size_t>(Metric::FanIn)];
+    auto& fanOut = m_columns[static_cast<size_t>(Metric::FanOut)];
+    std::fill(fanIn.begin(), fanIn.end(), 0);
+    std::fill(fanOut.begin(), fanOut.end(), 0);
+
+    // Callee lists are sorted and unique, so sizes are distinct counts.
+    for (const auto& [caller, callees] : calls) {
+        uint32_t row = find(caller);
+        if (row != npos) {
+            fanOut[row] = static_cast<uint32_t>(callees.size());
+        }
+        for (SymbolId callee : callees) {
+            uint32_t target = find(callee);
+            if (target != npos) {
+                ++fanIn[target];
+            }
+        }
+    }
+
+    // Every analyzed function is a caller, so each row has a name there.
+    SymbolNames names(calls);
+    for (uint32_t row = 0; row < size(); ++row) {
+        if (names.contains(m_symbols[row])) {
+            m_names[row] = names[m_symbols[row]];
+        }
+    }
+}
+
+std::vector<uint32_t> MetricsTable::select(Metric sortBy, bool descending,
+                                           const std::vector<Range>& ranges) const {
+    std::vector<uint32_t> rows;
+    rows.reserve(size());
+    for (uint32_t row = 0; row < size(); ++row) {
+        bool inside = std::all_of(ranges.begin(), ranges.end(), [&](const Range& range) {
+            uint32_t v = value(row, range.metric);
+            return range.min <= v && v <= range.max;
+        });
+        if (inside) {
+            rows.push_back(row);
+        }
+    }
+
+    const auto& column = m_columns[static_cast<size_t>(sortBy)];
+    std::sort(rows.begin(), rows.end(), [&](uint32_t a, uint32_t b) {
+        if (column[a] != column[b]) {
+            return descending ? column[a] > column[b] : column[a] < column[b];
+        }
+        if (m_names[a] != m_names[b]) {
+            return m_names[a] < m_names[b];
+        }
+        const SymbolTable& table = SymbolTable::instance();
+        return table.symbol(m_symbols[a]).usr < table.symbol(m_symbols[b]).usr;
+    });
+    return rows;
+}
+
+} // namespace CFGAnalyzer
@@ -0,0 +1,286 @@
+#include "frozen_graph.h"
+#include "graph_analysis.h"
+#include "graph_generator.h"
+#include <llvm/ADT/BitVector.h>
+#include <QTextStream>
+#include <algorithm>
+#include <unordered_set>
+
+namespace GraphGenerator {
+
+QString escapeDot(const QString& text) {
+    QString escaped;
+    escaped.reserve(text.size());
+    for (const QChar& c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        if (c == '\n') {
+            escaped += "\\n";
+            continue;
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+FrozenGraph::FrozenGraph() : m_analyses(std::make_shared<GraphAnalysisCache>()) {}
+
+std::shared_ptr<const FrozenGraph> FrozenGraph::freeze(const CFGGraph& graph) {
+    auto frozen = std::make_shared<FrozenGraph>();
+    const auto& nodes = graph.getNodes();
+    size_t count = nodes.size();
+    frozen->m_strings = graph.strings();
+
+    frozen->m_ids.reserve(count);
+    frozen->m_nodeFlags.reserve(count);
+    frozen->m_labels.reserve(count);
+    frozen->m_functionNames.reserve(count);
+    frozen->m_filenames.reserve(count);
+    frozen->m_startLines.reserve(count);
+    frozen->m_endLines.reserve(count);
+    frozen->m_statementOffsets.reserve(count + 1);
+    frozen->m_successorOffsets.reserve(count + 1);
+    frozen->m_statementOffsets.push_back(0);
+    frozen->m_successorOffsets.push_back(0);
+
+    for (const auto& [id, node] : nodes) {
+        frozen->m_ids.push_back(id);
+    }
+
+    // Successors that name no node (dangling edges) are dropped.
+    for (const auto& [id, node] : nodes) {
+        frozen->m_nodeFlags.push_back(node.flags);
+        frozen->m_labels.push_back(node.label);
+        frozen->m_functionNames.push_back(node.functionName);
+        frozen->m_filenames.push_back(node.filename);
+        frozen->m_startLines.push_back(node.startLine);
+        frozen->m_endLines.push_back(node.endLine);
+        frozen->m_statements.insert(frozen->m_statements.end(),
+                                    node.statements.begin(), node.statements.end());
+        frozen->m_statementOffsets.push_back(static_cast<uint32_t>(frozen->m_statements.size()));
+
+        for (const auto& [successor, flags] : node.successors) {
+            uint32_t target = frozen->indexOf(successor);
+            if (target == npos) continue;
+            frozen->m_successors.push_back(target);
+            frozen->m_edgeFlags.push_back(flags);
+        }
+        frozen->m_successorOffsets.push_back(static_cast<uint32_t>(frozen->m_successors.size()));
+    }
+
+    // Predecessors by counting sort over the successor array; each slice
+    // ends up in ascending source order.
+    std::vector<uint32_t>& offsets = frozen->m_predecessorOffsets;
+    offsets.assign(count + 1, 0);
+    for (uint32_t target : frozen->m_successors) {
+        ++offsets[target + 1];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    frozen->m_predecessors.resize(frozen->m_successors.size());
+    frozen->m_predecessorEdges.resize(frozen->m_successors.size());
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (uint32_t source = 0; source < count; ++source) {
+        uint32_t edge = frozen->firstEdge(source);
+        for (uint32_t target : frozen->successors(source)) {
+            uint32_t slot = cursor[target]++;
+            frozen->m_predecessors[slot] = source;
+            frozen->m_predecessorEdges[slot] = edge++;
+        }
+    }
+
+    return frozen;
+}
+
+uint32_t FrozenGraph::indexOf(int id) const {
+    auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    if (it == m_ids.end() || *it != id) {
+        return npos;
+    }
+    return static_cast<uint32_t>(it - m_ids.begin());
+}
+
+uint32_t FrozenGraph::edgeIndex(uint32_t from, uint32_t to) const {
+    for (uint32_t edge = m_successorOffsets[from]; edge < m_successorOffsets[from + 1]; ++edge) {
+        if (m_successors[edge] == to) {
+            return edge;
+        }
+    }
+    return npos;
+}
+
+bool FrozenGraph::isExceptionEdge(int fromId, int toId) const {
+    uint32_t from = indexOf(fromId);
+    uint32_t to = indexOf(toId);
+    if (from == npos || to == npos) {
+        return false;
+    }
+    uint32_t edge = edgeIndex(from, to);
+    return edge != npos && (m_edgeFlags[edge] & ExceptionEdge);
+}
+
+bool FrozenGraph::hasNodeFlag(int id, NodeFlags flag) const {
+    uint32_t index = indexOf(id);
+    return index != npos && (m_nodeFlags[index] & flag);
+}
+
+std::string FrozenGraph::toDot() const {
+    return writeDot(nullptr, nullptr);
+}
+
+std::string FrozenGraph::toDot(const llvm::BitVector& visible) const {
+    return writeDot(&visible, nullptr);
+}
+
+std::string FrozenGraph::toDot(const std::vector<uint32_t>& representative) const {
+    return writeDot(nullptr, &representative);
+}
+
+std::string FrozenGraph::writeDot(const llvm::BitVector* visible,
+                                  const std::vector<uint32_t>* representative) const {
+    auto shown = [visible, representative](uint32_t index) {
+        if (representative) return (*representative)[index] == index;
+        return !visible || visible->test(index);
+    };
+
+    // Number of hidden nodes each drawn node stands for.
+    std::vector<uint32_t> folded;
+    if (representative) {
+        folded.assign(nodeCount(), 0);
+        for (uint32_t i = 0; i < nodeCount(); ++i) {
+            uint32_t into = (*representative)[i];
+            if (into != npos && into != i) ++folded[into];
+        }
+    }
+
+    QString dot;
+    QTextStream out(&dot);
+    out << "digraph CFG {\n";
+    out << "  rankdir=TB;\n";
+    out << "  node [shape=rectangle, style=filled, fillcolor=lightgray];\n";
+    out << "  edge [arrowsize=0.8];\n\n";
+
+    const AttributeRegistry& attributes = AttributeRegistry::instance();
+
+    for (uint32_t i = 0; i < nodeCount(); ++i) {
+        if (!shown(i)) continue;
+        int nodeID = m_ids[i];
+        bool collapsed = !folded.empty() && folded[i] > 0;
+        out << "  node" << nodeID << " [id=\"node" << nodeID << "\", label=\"";
+        if (collapsed) {
+            out << "+ ";
+        }
+        out << escapeDot(m_labels[i]);
+        for (const StatementText& stmt : statements(i)) {
+            out << "\\n" << escapeDot(stmt.toQString());
+        }
+        if (collapsed) {
+            out << "\\n(" << folded[i] << " more nodes)";
+        }
+        out << "\"";
+
+        if (!m_functionNames[i].isEmpty()) {
+            out << ", function=\"" << escapeDot(m_functionNames[i]) << "\"";
+        }
+        if (m_startLines[i] != -1 && m_endLines[i] != -1) {
+            out << ", location=\"" << escapeDot(m_filenames[i]) << ":" << m_startLines[i]
+                << "-" << m_endLines[i] << "\"";
+        }
+
+        NodeFlags flags = m_nodeFlags[i] | (collapsed ? Expandable : 0);
+        const std::string& style = attributes.nodeStyle(flags);
+        if (!style.empty()) {
+            out << ", " << style.c_str();
+        }
+        out << "];\n";
+    }
+
+    out << "\n";
+    for (uint32_t i = 0; i < nodeCount(); ++i) {
+        if (!shown(i)) continue;
+        for (uint32_t edge = m_successorOffsets[i]; edge < m_successorOffsets[i + 1]; ++edge) {
+            if (!shown(m_successors[edge])) continue;
+            // Edge ids let the web view highlight paths by node pair.
+            int to = m_ids[m_successors[edge]];
+            out << "  node" << m_ids[i] << " -> node" << to
+                << " [id=\"edge" << m_ids[i] << "_" << to << "\"";
+            const std::string& style = attributes.edgeStyle(m_edgeFlags[edge]);
+            if (!style.empty()) {
+                out << ", " << style.c_str();
+            }
+            out << "];\n";
+        }
+    }
+
+    if (representative) {
+        // Edges touching folded nodes, once per pair of drawn nodes and only
+        // where no real edge already joins them.
+        std::unordered_set<uint64_t> drawn;
+        for (uint32_t i = 0; i < nodeCount(); ++i) {
+            uint32_t from = (*representative)[i];
+            if (from == npos) continue;
+            for (uint32_t target : successors(i)) {
+                uint32_t to = (*representative)[target];
+                if (to == npos || to == from || (from == i && to == target)) continue;
+                if (edgeIndex(from, to) != npos) continue;
+                if (!drawn.insert(static_cast<uint64_t>(from) << 32 | to).second) continue;
+                out << "  node" << m_ids[from] << " -> node" << m_ids[to] << " [style=dashed];\n";
+            }
+        }
+    }
+
+    out << "}\n";
+    out.flush();
+    return dot.toStdString();
+}
+
+std::shared_ptr<const FrozenGraph> FrozenGraph::withLinesShifted(int delta) const {
+    auto shifted = std::make_shared<FrozenGraph>(*this);
+    for (size_t i = 0; i < nodeCount(); ++i) {
+        if (shifted->m_startLines[i] == -1 || shifted->m_endLines[i] == -1) continue;
+        shifted->m_startLines[i] += delta;
+        shifted->m_endLines[i] += delta;
+    }
+    return shifted;
+}
+
+const DominatorTree& FrozenGraph::dominators() const {
+    std::call_once(m_analyses->dominatorsOnce, [this] {
+        m_analyses->dominators =
+            std::make_unique<DominatorTree>(*this, DominatorTree::Direction::Forward);
+    });
+    return *m_analyses->dominators;
+}
+
+const DominatorTree& FrozenGraph::postDominators() const {
+    std::call_once(m_analyses->postDominatorsOnce, [this] {
+        m_analyses->postDominators =
+            std::make_unique<DominatorTree>(*this, DominatorTree::Direction::Post);
+    });
+    return *m_analyses->postDominators;
+}
+
+const ControlDependence& FrozenGraph::controlDependence() const {
+    std::call_once(m_analyses->controlDependenceOnce, [this] {
+        m_analyses->controlDependence =
+            std::make_unique<ControlDependence>(postDominators(), nodeCount());
+    });
+    return *m_analyses->controlDependence;
+}
+
+const RegionForest& FrozenGraph::regions() const {
+    std::call_once(m_analyses->regionsOnce, [this] {
+        m_analyses->regions =
+            std::make_unique<RegionForest>(*this, dominators(), postDominators());
+    });
+    return *m_analyses->regions;
+}
+
+const StronglyConnectedComponents& FrozenGraph::components() const {
+    std::call_once(m_analyses->componentsOnce, [this] {
+        m_analyses->components = std::make_unique<StronglyConnectedComponents>(*this);
+    });
+    return *m_analyses->components;
+}
+
+} // namespace GraphGenerator
@@ -0,0 +1,584 @@
+#include "graph_analysis.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace GraphGenerator {
+
+namespace {
+
+// Packs (key, value) pairs into CSR offsets and values by counting sort on
+// key, keeping the order of the pairs within each key.
+void buildRows(const std::vector<std::pair<uint32_t, uint32_t>>& pairs, size_t rows,
+               std::vector<uint32_t>& offsets, std::vector<uint32_t>& values) {
+    offsets.assign(rows + 1, 0);
+    for (const auto& pair : pairs) {
+        ++offsets[pair.first + 1];
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    values.resize(pairs.size());
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (const auto& pair : pairs) {
+        values[cursor[pair.first]++] = pair.second;
+    }
+}
+
+} // namespace
+
+DominatorTree::DominatorTree(const FrozenGraph& graph, Direction direction)
+    : m_direction(direction), m_root(static_cast<uint32_t>(graph.nodeCount())) {
+    const uint32_t count = m_root;
+    const bool post = direction == Direction::Post;
+    auto forward = [&](uint32_t v) { return post ? graph.predecessors(v) : graph.successors(v); };
+    auto backward = [&](uint32_t v) { return post ? graph.successors(v) : graph.predecessors(v); };
+
+    // Nodes hanging off the virtual root: entries (exits), then whatever
+    // they leave unreached, lowest index first.
+    std::vector<uint32_t> rootChildren;
+    std::vector<char> isRootChild(count, 0);
+    for (uint32_t v = 0; v < count; ++v) {
+        if (backward(v).empty()) {
+            rootChildren.push_back(v);
+            isRootChild[v] = 1;
+        }
+    }
+
+    // Iterative DFS from the virtual root recording postorder numbers.
+    std::vector<uint32_t> postNumber(count + 1, FrozenGraph::npos);
+    std::vector<uint32_t> postorder;
+    postorder.reserve(count + 1);
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    auto walk = [&](uint32_t start) {
+        postNumber[start] = 0;
+        stack.emplace_back(start, 0);
+        while (!stack.empty()) {
+            auto& [v, next] = stack.back();
+            auto out = forward(v);
+            if (next < out.size()) {
+                uint32_t w = out[next++];
+                if (postNumber[w] == FrozenGraph::npos) {
+                    postNumber[w] = 0;
+                    stack.emplace_back(w, 0);
+                }
+                continue;
+            }
+            postNumber[v] = static_cast<uint32_t>(postorder.size());
+            postorder.push_back(v);
+            stack.pop_back();
+        }
+    };
+    for (uint32_t v : rootChildren) {
+        walk(v);
+    }
+    for (uint32_t v = 0; v < count; ++v) {
+        if (postNumber[v] == FrozenGraph::npos) {
+            rootChildren.push_back(v);
+            isRootChild[v] = 1;
+            walk(v);
+        }
+    }
+    postNumber[m_root] = static_cast<uint32_t>(postorder.size());
+    postorder.push_back(m_root);
+
+    auto intersect = [&](uint32_t a, uint32_t b) {
+        while (a != b) {
+            while (postNumber[a] < postNumber[b]) a = m_idom[a];
+            while (postNumber[b] < postNumber[a]) b = m_idom[b];
+        }
+        return a;
+    };
+
+    m_idom.assign(count + 1, FrozenGraph::npos);
+    m_idom[m_root] = m_root;
+    for (bool changed = true; changed;) {
+        changed = false;
+        // Reverse postorder, skipping the root at the back of postorder.
+        for (size_t i = count; i-- > 0;) {
+            uint32_t v = postorder[i];
+            uint32_t idom = isRootChild[v] ? m_root : FrozenGraph::npos;
+            for (uint32_t p : backward(v)) {
+                if (m_idom[p] == FrozenGraph::npos) continue;
+                idom = idom == FrozenGraph::npos ? p : intersect(p, idom);
+            }
+            if (m_idom[v] != idom) {
+                m_idom[v] = idom;
+                changed = true;
+            }
+        }
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    pairs.reserve(count);
+    for (uint32_t v = 0; v < count; ++v) {
+        pairs.emplace_back(m_idom[v], v);
+    }
+    buildRows(pairs, count + 1, m_childOffsets, m_children);
+
+    // Preorder numbering of the tree for O(1) dominates().
+    m_preorder.assign(count + 1, 0);
+    m_lastDescendant.assign(count + 1, 0);
+    uint32_t number = 0;
+    stack.clear();
+    m_preorder[m_root] = number++;
+    stack.emplace_back(m_root, 0);
+    while (!stack.empty()) {
+        auto& [v, next] = stack.back();
+        uint32_t first = m_childOffsets[v];
+        if (first + next < m_childOffsets[v + 1]) {
+            uint32_t w = m_children[first + next++];
+            m_preorder[w] = number++;
+            stack.emplace_back(w, 0);
+            continue;
+        }
+        m_lastDescendant[v] = number - 1;
+        stack.pop_back();
+    }
+
+    // Frontiers: walk up from each predecessor of a join point until its
+    // immediate dominator. The root counts as a predecessor of its children.
+    pairs.clear();
+    std::vector<uint32_t> lastAdded(count + 1, FrozenGraph::npos);
+    for (uint32_t v = 0; v < count; ++v) {
+        auto in = backward(v);
+        if (in.size() + (isRootChild[v] ? 1 : 0) < 2) continue;
+        for (uint32_t p : in) {
+            for (uint32_t runner = p; runner != m_idom[v]; runner = m_idom[runner]) {
+                if (lastAdded[runner] == v) break;
+                lastAdded[runner] = v;
+                pairs.emplace_back(runner, v);
+            }
+        }
+    }
+    buildRows(pairs, count + 1, m_frontierOffsets, m_frontier);
+}
+
+ControlDependence::ControlDependence(const DominatorTree& postDominators, size_t nodeCount) {
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    for (uint32_t y = 0; y < nodeCount; ++y) {
+        for (uint32_t x : postDominators.frontier(y)) {
+            pairs.emplace_back(x, y);
+        }
+    }
+    buildRows(pairs, nodeCount, m_dependentOffsets, m_dependents);
+    for (auto& pair : pairs) {
+        std::swap(pair.first, pair.second);
+    }
+    std::sort(pairs.begin(), pairs.end());
+    buildRows(pairs, nodeCount, m_controllerOffsets, m_controllers);
+}
+
+RegionForest::RegionForest(const FrozenGraph& graph, const DominatorTree& dominators,
+                           const DominatorTree& postDominators) {
+    const uint32_t count = static_cast<uint32_t>(graph.nodeCount());
+
+    struct Candidate {
+        Region region;
+        std::vector<uint32_t> nodes;
+    };
+    std::vector<Candidate> candidates;
+    // Visit stamps, so each walk starts from a clean slate without clearing.
+    std::vector<uint32_t> seen(count, FrozenGraph::npos);
+    std::vector<uint32_t> worklist;
+    uint32_t walk = 0;
+
+    // Natural loops, one per header.
+    for (uint32_t header = 0; header < count; ++header) {
+        worklist.clear();
+        for (uint32_t latch : graph.predecessors(header)) {
+            if (dominators.dominates(header, latch)) {
+                worklist.push_back(latch);
+            }
+        }
+        if (worklist.empty()) continue;
+
+        Candidate loop{Region{Kind::Loop, header, FrozenGraph::npos, FrozenGraph::npos, 0}, {header}};
+        seen[header] = walk;
+        while (!worklist.empty()) {
+            uint32_t v = worklist.back();
+            worklist.pop_back();
+            if (seen[v] == walk) continue;
+            seen[v] = walk;
+            loop.nodes.push_back(v);
+            for (uint32_t p : graph.predecessors(v)) {
+                if (seen[p] != walk) worklist.push_back(p);
+            }
+        }
+        ++walk;
+        // A block looping on itself has nothing to fold.
+        if (loop.nodes.size() > 1) {
+            candidates.push_back(std::move(loop));
+        }
+    }
+
+    // Conditionals: from a branch forward to its immediate post-dominator.
+    for (uint32_t branch = 0; branch < count; ++branch) {
+        if (graph.successors(branch).size() < 2) continue;
+        uint32_t exit = postDominators.idom(branch);
+        if (exit == FrozenGraph::npos || !dominators.dominates(branch, exit)) continue;
+
+        Candidate conditional{Region{Kind::Conditional, branch, exit, FrozenGraph::npos, 0}, {}};
+        bool single = true;
+        worklist.assign(1, branch);
+        seen[exit] = walk;
+        while (!worklist.empty() && single) {
+            uint32_t v = worklist.back();
+            worklist.pop_back();
+            if (seen[v] == walk) continue;
+            seen[v] = walk;
+            // A node the branch does not dominate is entered from outside.
+            single = dominators.dominates(branch, v) && postDominators.dominates(exit, v);
+            conditional.nodes.push_back(v);
+            for (uint32_t s : graph.successors(v)) {
+                if (seen[s] != walk) worklist.push_back(s);
+            }
+        }
+        ++walk;
+        if (single) {
+            candidates.push_back(std::move(conditional));
+        }
+    }
+
+    // Largest first, loops before conditionals of the same size: each
+    // region then only has to agree with the regions already accepted.
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& a, const Candidate& b) {
+                         return a.nodes.size() > b.nodes.size();
+                     });
+
+    m_innermost.assign(count, FrozenGraph::npos);
+    m_headed.assign(count, FrozenGraph::npos);
+    m_nodeOffsets.assign(1, 0);
+    std::vector<uint32_t> sizes;
+    for (Candidate& candidate : candidates) {
+        uint32_t parent = m_innermost[candidate.nodes.front()];
+        bool nested = std::all_of(candidate.nodes.begin(), candidate.nodes.end(),
+                                  [&](uint32_t v) { return m_innermost[v] == parent; });
+        if (!nested || (parent != FrozenGraph::npos && sizes[parent] == candidate.nodes.size())) {
+            continue;
+        }
+
+        uint32_t id = static_cast<uint32_t>(m_regions.size());
+        Region region = candidate.region;
+        region.parent = parent;
+        region.depth = parent == FrozenGraph::npos ? 0 : m_regions[parent].depth + 1;
+        m_regions.push_back(region);
+        sizes.push_back(static_cast<uint32_t>(candidate.nodes.size()));
+
+        std::sort(candidate.nodes.begin(), candidate.nodes.end());
+        for (uint32_t v : candidate.nodes) {
+            m_innermost[v] = id;
+        }
+        if (m_headed[region.entry] == FrozenGraph::npos) {
+            m_headed[region.entry] = id;
+        }
+        m_nodes.insert(m_nodes.end(), candidate.nodes.begin(), candidate.nodes.end());
+        m_nodeOffsets.push_back(static_cast<uint32_t>(m_nodes.size()));
+    }
+}
+
+StronglyConnectedComponents::StronglyConnectedComponents(const FrozenGraph& graph) {
+    const uint32_t count = static_cast<uint32_t>(graph.nodeCount());
+    std::vector<uint32_t> order(count, FrozenGraph::npos);
+    std::vector<uint32_t> low(count, 0);
+    std::vector<char> onStack(count, 0);
+    std::vector<uint32_t> stack;
+    // Explicit call stack of (node, next successor position).
+    std::vector<std::pair<uint32_t, uint32_t>> frames;
+    // Tarjan finds components callees first; they are renumbered below.
+    std::vector<uint32_t> found(count, FrozenGraph::npos);
+    uint32_t visited = 0;
+    uint32_t foundCount = 0;
+
+    auto enter = [&](uint32_t v) {
+        order[v] = low[v] = visited++;
+        stack.push_back(v);
+        onStack[v] = 1;
+        frames.emplace_back(v, 0);
+    };
+
+    for (uint32_t root = 0; root < count; ++root) {
+        if (order[root] != FrozenGraph::npos) continue;
+        enter(root);
+        while (!frames.empty()) {
+            auto& [v, next] = frames.back();
+            auto out = graph.successors(v);
+            if (next < out.size()) {
+                uint32_t w = out[next++];
+                if (order[w] == FrozenGraph::npos) {
+                    enter(w);
+                } else if (onStack[w]) {
+                    low[v] = std::min(low[v], order[w]);
+                }
+                continue;
+            }
+
+            uint32_t done = v;
+            frames.pop_back();
+            if (low[done] == order[done]) {
+                uint32_t w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w] = 0;
+                    found[w] = foundCount;
+                } while (w != done);
+                ++foundCount;
+            }
+            if (!frames.empty()) {
+                uint32_t parent = frames.back().first;
+                low[parent] = std::min(low[parent], low[done]);
+            }
+        }
+    }
+
+    // Number components by their lowest node.
+    std::vector<uint32_t> renumber(foundCount, FrozenGraph::npos);
+    uint32_t components = 0;
+    m_component.resize(count);
+    for (uint32_t v = 0; v < count; ++v) {
+        if (renumber[found[v]] == FrozenGraph::npos) {
+            renumber[found[v]] = components++;
+        }
+        m_component[v] = renumber[found[v]];
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    pairs.reserve(count);
+    for (uint32_t v = 0; v < count; ++v) {
+        pairs.emplace_back(m_component[v], v);
+    }
+    buildRows(pairs, components, m_memberOffsets, m_members);
+
+    m_cyclic.assign(components, 0);
+    pairs.clear();
+    for (uint32_t v = 0; v < count; ++v) {
+        uint32_t from = m_component[v];
+        if (m_memberOffsets[from + 1] - m_memberOffsets[from] > 1) {
+            m_cyclic[from] = 1;
+        }
+        for (uint32_t w : graph.successors(v)) {
+            if (m_component[w] == from) {
+                m_cyclic[from] = 1;
+            } else {
+                pairs.emplace_back(from, m_component[w]);
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    buildRows(pairs, components, m_successorOffsets, m_successors);
+}
+
+size_t StronglyConnectedComponents::cyclicCount() const {
+    return static_cast<size_t>(std::count(m_cyclic.begin(), m_cyclic.end(), 1));
+}
+
+PathEnumerator::PathEnumerator(const FrozenGraph& graph, uint32_t from, uint32_t to, Options options)
+    : m_graph(graph), m_from(from), m_to(to), m_options(std::move(options))
+{
+    m_done = from >= graph.nodeCount() || to >= graph.nodeCount();
+}
+
+double PathEnumerator::weightOf(uint32_t edge) const {
+    return m_options.weight ? m_options.weight(edge) : 1.0;
+}
+
+// Summed front to back, so the same nodes always get the same weight.
+double PathEnumerator::pathWeight(const std::vector<uint32_t>& nodes) const {
+    double weight = 0;
+    for (size_t i = 0; i + 1 < nodes.size(); ++i) {
+        weight += weightOf(m_graph.edgeIndex(nodes[i], nodes[i + 1]));
+    }
+    return weight;
+}
+
+// Counts one edge visit against maxSteps.
+bool PathEnumerator::step() {
+    if (++m_steps <= m_options.maxSteps) return true;
+    m_done = true;
+    m_truncated = true;
+    return false;
+}
+
+bool PathEnumerator::next(Path& path) {
+    if (m_done) return false;
+    if (m_count >= m_options.maxPaths) {
+        // Only a path beyond the limit makes the result truncated; running
+        // out of steps while looking for one sets the flag in step().
+        Path beyond;
+        if (advance(beyond)) {
+            m_truncated = true;
+        }
+        m_done = true;
+        return false;
+    }
+    if (!advance(path)) {
+        m_done = true;
+        return false;
+    }
+    ++m_count;
+    return true;
+}
+
+bool PathEnumerator::advance(Path& path) {
+    return m_options.order == Order::Shortest ? nextShortest(path) : nextDepthFirst(path);
+}
+
+// Dijkstra from from to m_to around the blocked nodes and edges.
+bool PathEnumerator::shortestPath(uint32_t from, Path& path) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    m_distance.assign(m_graph.nodeCount(), infinity);
+    m_parent.assign(m_graph.nodeCount(), FrozenGraph::npos);
+
+    using Entry = std::pair<double, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    m_distance[from] = 0;
+    queue.emplace(0, from);
+    while (!queue.empty()) {
+        auto [distance, node] = queue.top();
+        queue.pop();
+        if (distance > m_distance[node]) continue;
+        if (node == m_to) break;
+        uint32_t edge = m_graph.firstEdge(node);
+        for (uint32_t target : m_graph.successors(node)) {
+            uint32_t current = edge++;
+            if (!step()) return false;
+            if (m_blockedNodes[target] || m_blockedEdges[current]) continue;
+            double candidate = distance + weightOf(current);
+            if (candidate < m_distance[target]) {
+                m_distance[target] = candidate;
+                m_parent[target] = node;
+                queue.emplace(candidate, target);
+            }
+        }
+    }
+    if (m_distance[m_to] == infinity) return false;
+
+    path.nodes.clear();
+    for (uint32_t node = m_to; node != from; node = m_parent[node]) {
+        path.nodes.push_back(node);
+    }
+    path.nodes.push_back(from);
+    std::reverse(path.nodes.begin(), path.nodes.end());
+    path.weight = pathWeight(path.nodes);
+    return true;
+}
+
+bool PathEnumerator::nextShortest(Path& path) {
+    if (!m_started) {
+        m_started = true;
+        m_blockedNodes.assign(m_graph.nodeCount(), 0);
+        m_blockedEdges.assign(m_graph.edgeCount(), 0);
+        Path first;
+        if (shortestPath(m_from, first) && first.nodes.size() <= m_options.maxLength) {
+            m_candidates.emplace(first.weight, std::move(first.nodes));
+        }
+    } else {
+        // Deviate from the last path at each of its nodes: keep the root up
+        // to the spur node, and take the shortest way on that no accepted
+        // path with the same root already took.
+        const std::vector<uint32_t> last = m_accepted.back().nodes;
+        for (size_t i = 0; i + 1 < last.size(); ++i) {
+            uint32_t spur = last[i];
+            std::vector<uint32_t> blocked;
+            for (const Path& accepted : m_accepted) {
+                if (accepted.nodes.size() > i + 1 &&
+                    std::equal(last.begin(), last.begin() + i + 1, accepted.nodes.begin())) {
+                    uint32_t edge = m_graph.edgeIndex(spur, accepted.nodes[i + 1]);
+                    m_blockedEdges[edge] = 1;
+                    blocked.push_back(edge);
+                }
+            }
+
+            Path spurPath;
+            bool found = shortestPath(spur, spurPath);
+            for (uint32_t edge : blocked) {
+                m_blockedEdges[edge] = 0;
+            }
+            if (m_done) return false;
+            if (found && i + spurPath.nodes.size() <= m_options.maxLength) {
+                std::vector<uint32_t> nodes(last.begin(), last.begin() + i);
+                nodes.insert(nodes.end(), spurPath.nodes.begin(), spurPath.nodes.end());
+                double weight = pathWeight(nodes);
+                m_candidates.emplace(weight, std::move(nodes));
+            }
+            // Later spurs extend this root, which must stay simple.
+            m_blockedNodes[spur] = 1;
+        }
+        for (size_t i = 0; i + 1 < last.size(); ++i) {
+            m_blockedNodes[last[i]] = 0;
+        }
+    }
+
+    if (m_candidates.empty()) return false;
+    auto best = m_candidates.begin();
+    path.weight = best->first;
+    path.nodes = best->second;
+    m_candidates.erase(best);
+    m_accepted.push_back(path);
+    return true;
+}
+
+bool PathEnumerator::nextDepthFirst(Path& path) {
+    auto emit = [this, &path]() {
+        path.nodes.clear();
+        for (const auto& [node, slot] : m_stack) {
+            path.nodes.push_back(node);
+        }
+        path.weight = pathWeight(path.nodes);
+        return true;
+    };
+
+    if (!m_started) {
+        m_started = true;
+        // Branches that cannot reach the target are never entered.
+        m_reachesTarget.assign(m_graph.nodeCount(), 0);
+        std::vector<uint32_t> worklist{m_to};
+        m_reachesTarget[m_to] = 1;
+        while (!worklist.empty()) {
+            uint32_t node = worklist.back();
+            worklist.pop_back();
+            for (uint32_t predecessor : m_graph.predecessors(node)) {
+                if (!m_reachesTarget[predecessor]) {
+                    m_reachesTarget[predecessor] = 1;
+                    worklist.push_back(predecessor);
+                }
+            }
+        }
+        if (!m_reachesTarget[m_from]) return false;
+
+        m_onPath.assign(m_graph.nodeCount(), 0);
+        m_onPath[m_from] = 1;
+        m_stack.emplace_back(m_from, 0);
+        if (m_from == m_to) return emit();
+    }
+
+    while (!m_stack.empty()) {
+        uint32_t node = m_stack.back().first;
+        FrozenGraph::Range<uint32_t> successors = m_graph.successors(node);
+        uint32_t slot = m_stack.back().second;
+        if (node == m_to || slot >= successors.size()) {
+            m_onPath[node] = 0;
+            m_stack.pop_back();
+            continue;
+        }
+        ++m_stack.back().second;
+        if (!step()) return false;
+
+        uint32_t target = successors[slot];
+        if (m_onPath[target] || !m_reachesTarget[target] ||
+            m_stack.size() >= m_options.maxLength) {
+            continue;
+        }
+        m_onPath[target] = 1;
+        m_stack.emplace_back(target, 0);
+        if (target == m_to) return emit();
+    }
+    return false;
+}
+
+} // namespace GraphGenerator
@@ -0,0 +1,23 @@
+#include "graph_arena.h"
+
+namespace GraphGenerator {
+
+GraphArena::GraphArena(size_t initialSize)
+    : m_upstream(m_stats), m_buffer(initialSize, &m_upstream) {}
+
+void* GraphArena::do_allocate(size_t bytes, size_t alignment) {
+    ++m_stats.allocations;
+    return m_buffer.allocate(bytes, alignment);
+}
+
+void* GraphArena::Upstream::do_allocate(size_t bytes, size_t alignment) {
+    ++m_stats.blocks;
+    m_stats.bytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void GraphArena::Upstream::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+} // namespace GraphGenerator
@@ -0,0 +1,73 @@
+#include "graph_attributes.h"
+#include <llvm/ADT/bit.h>
+
+namespace GraphGenerator {
+
+namespace {
+
+const std::string& noStyle() {
+    static const std::string empty;
+    return empty;
+}
+
+} // namespace
+
+AttributeRegistry& AttributeRegistry::instance() {
+    static AttributeRegistry registry;
+    return registry;
+}
+
+AttributeRegistry::AttributeRegistry() {
+    // Same order as the NodeFlag and EdgeFlag bits.
+    registerNodeFlag("expandable", "shape=folder, fillcolor=lightblue");
+    registerNodeFlag("try", "shape=ellipse, fillcolor=lightblue");
+    registerNodeFlag("throws", "shape=octagon, fillcolor=orange");
+    registerEdgeFlag("exception", "color=red, style=dashed, label=\"exception\", fontcolor=red");
+    registerEdgeFlag("true", "label=\"True\", color=blue");
+    registerEdgeFlag("false", "label=\"False\", color=blue");
+}
+
+NodeFlags AttributeRegistry::registerNodeFlag(const std::string& name, const std::string& dotStyle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_nodes.add(name, dotStyle);
+}
+
+EdgeFlags AttributeRegistry::registerEdgeFlag(const std::string& name, const std::string& dotStyle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_edges.add(name, dotStyle);
+}
+
+uint32_t AttributeRegistry::Table::add(const std::string& name, const std::string& dotStyle) {
+    unsigned used = count.load(std::memory_order_relaxed);
+    for (unsigned i = 0; i < used; ++i) {
+        if (attributes[i].name == name) {
+            return 1u << i;
+        }
+    }
+    if (used == kMaxFlags) {
+        return 0;
+    }
+
+    // Readers only look at slots below count, so the slot is filled first.
+    attributes[used] = Attribute{name, dotStyle};
+    if (!dotStyle.empty()) {
+        styledMask.fetch_or(1u << used, std::memory_order_release);
+    }
+    count.store(used + 1, std::memory_order_release);
+    return 1u << used;
+}
+
+const std::string& AttributeRegistry::Table::style(uint32_t flags) const {
+    uint32_t styled = flags & styledMask.load(std::memory_order_acquire);
+    return styled ? attributes[llvm::countr_zero(styled)].dotStyle : noStyle();
+}
+
+const AttributeRegistry::Attribute* AttributeRegistry::Table::find(uint32_t bit) const {
+    if (bit == 0 || (bit & (bit - 1)) != 0) {
+        return nullptr;
+    }
+    unsigned index = llvm::countr_zero(bit);
+    return index < count.load(std::memory_order_acquire) ? &attributes[index] : nullptr;
+}
+
+} // namespace GraphGenerator
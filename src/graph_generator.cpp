@@ -1,5 +1,6 @@
 #include "graph_generator.h"
 #include "parser.h"
+#include "shared_file_cache.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -10,6 +11,8 @@
 #include <clang/Frontend/FrontendOptions.h>
 #include <clang/Basic/LangOptions.h>
 #include <clang/Parse/ParseAST.h>
+#include <clang/Lex/Lexer.h>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/Support/raw_ostream.h>
 #include <QFile>
 #include <QTextStream>
@@ -18,18 +21,21 @@
 namespace GraphGenerator {
 
     void CFGGraph::addStatement(int nodeID, const QString& stmt) {
-        QString cleaned;
-        cleaned.reserve(stmt.size());
-        for (const QChar& c : stmt) {
-            if (c == '\n') cleaned += "\\n";
-            else if (c == '"') cleaned += "\\\"";
-            else cleaned += c;
+        if (nodes.find(nodeID) == nodes.end()) {
+            addNode(nodeID);
         }
-        
+        nodes[nodeID].statements.push_back(StatementText(m_strings->intern(stmt)));
+    }
+
+    void CFGGraph::addStatement(int nodeID, llvm::StringRef stmt) {
+        addStatement(nodeID, StatementText(m_strings->intern(stmt)));
+    }
+
+    void CFGGraph::addStatement(int nodeID, const StatementText& stmt) {
         if (nodes.find(nodeID) == nodes.end()) {
             addNode(nodeID);
         }
-        nodes[nodeID].statements.push_back(cleaned);
+        nodes[nodeID].statements.push_back(stmt);
     }
 
     QString CFGGraph::getNodeLabel(int nodeID) const {
@@ -42,37 +48,38 @@ namespace GraphGenerator {
 
     void CFGGraph::addNode(int id, const QString& label) {
         if (nodes.find(id) == nodes.end()) {
-            nodes[id] = CFGNode(id, label);
+            nodes.try_emplace(id, id, label);
         }
     }
 
     void CFGGraph::addExceptionEdge(int sourceID, int targetID) {
-        exceptionEdges.insert({sourceID, targetID});
-
-        if (nodes.find(sourceID) == nodes.end()) {
-            addNode(sourceID);
-        }
-        nodes[sourceID].successors.insert(targetID);
-    }
-
-    bool CFGGraph::isExceptionEdge(int sourceID, int targetID) const {
-        return exceptionEdges.find({sourceID, targetID}) != exceptionEdges.end();
+        setEdgeFlags(sourceID, targetID, ExceptionEdge);
     }
 
-    void CFGGraph::markNodeAsTryBlock(int nodeID) {
-        tryBlocks.insert(nodeID);
+    void CFGGraph::setNodeFlags(int nodeID, NodeFlags flags) {
+        if (nodes.find(nodeID) == nodes.end()) {
+            addNode(nodeID);
+        }
+        nodes[nodeID].flags |= flags;
     }
 
-    void CFGGraph::markNodeAsThrowingException(int nodeID) {
-        throwingBlocks.insert(nodeID);
+    NodeFlags CFGGraph::nodeFlags(int nodeID) const {
+        auto it = nodes.find(nodeID);
+        return it != nodes.end() ? it->second.flags : 0;
     }
 
-    bool CFGGraph::isNodeTryBlock(int nodeID) const {
-        return tryBlocks.find(nodeID) != tryBlocks.end();
+    void CFGGraph::setEdgeFlags(int sourceID, int targetID, EdgeFlags flags) {
+        addEdge(sourceID, targetID);
+        nodes[sourceID].successors[targetID] |= flags;
     }
 
-    bool CFGGraph::isNodeThrowingException(int nodeID) const {
-        return throwingBlocks.find(nodeID) != throwingBlocks.end();
+    EdgeFlags CFGGraph::edgeFlags(int sourceID, int targetID) const {
+        auto node = nodes.find(sourceID);
+        if (node == nodes.end()) {
+            return 0;
+        }
+        auto edge = node->second.successors.find(targetID);
+        return edge != node->second.successors.end() ? edge->second : 0;
     }
 
     size_t CFGGraph::getNodeCount() const {
@@ -93,68 +100,7 @@ namespace GraphGenerator {
             qWarning() << "Failed to open file for writing:" << filename;
             return;
         }
-    
-        QTextStream out(&file);
-        out << "digraph CFG {\n";
-        out << "  node [fontname=\"Arial\", fontsize=10];\n";
-        out << "  edge [fontname=\"Arial\", fontsize=8];\n\n";
-        
-        // Write nodes
-        for (const auto& [nodeID, node] : nodes) {
-            out << "  " << nodeID << " [label=\"" << node.label;
-            
-            // Add statements to label
-            if (!node.statements.empty()) {
-                out << "\\n";
-                for (const auto& stmt : node.statements) {
-                    out << stmt << "\\n";
-                }
-            }
-            
-            out << "\"";
-            
-            // Apply node styling based on properties
-            if (isNodeExpandable(nodeID)) {
-                out << ", shape=folder, style=filled, fillcolor=lightblue";
-                out << ", tooltip=\"Click to expand/collapse\"";
-            } else if (isNodeTryBlock(nodeID)) {
-                out << ", shape=ellipse, style=filled, fillcolor=lightblue";
-            } else if (isNodeThrowingException(nodeID)) {
-                out << ", shape=octagon, style=filled, fillcolor=orange";
-            } else {
-                out << ", shape=rectangle, style=filled, fillcolor=lightgray";
-            }
-            
-            // Add source location if available
-            if (node.startLine != -1 && node.endLine != -1) {
-                out << ", URL=\"javascript:void(0)\"";
-                out << ", target=\"_blank\"";
-            }
-            
-            out << "];\n";
-        }
-        
-        for (const auto& [nodeID, node] : nodes) {
-            for (int successorID : node.successors) {
-                out << "  " << nodeID << " -> " << successorID;
-                
-                // Style edges based on type
-                if (isExceptionEdge(nodeID, successorID)) {
-                    out << " [color=red, style=dashed, label=\"exception\", fontcolor=red]";
-                } else if (isNodeExpandable(nodeID)) {
-                    out << " [color=blue, penwidth=2]";
-                } else {
-                    out << " [color=black]";
-                }
-                
-                out << ";\n";
-            }
-        }
-        
-        out << "\n  // Layout improvements\n";
-        out << "  graph [rankdir=TB, nodesep=0.5, ranksep=0.5];\n";
-        out << "  edge [arrowsize=0.8];\n";
-        out << "}\n";
+        file.write(QByteArray::fromStdString(toDot()));
     }
 
     void CFGGraph::writeToJsonFile(const QString& filename, const json& astJson, const json& functionCallJson) {
@@ -170,13 +116,13 @@ namespace GraphGenerator {
             
             json statementsJson = json::array();
             for (const auto& stmt : node.statements) {
-                statementsJson.push_back(stmt.toStdString());
+                statementsJson.push_back(stmt.str().str());
             }
             nodeJson["statements"] = statementsJson;
             
             // Add special properties
-            nodeJson["isTryBlock"] = isNodeTryBlock(nodeID);
-            nodeJson["isThrowingException"] = isNodeThrowingException(nodeID);
+            nodeJson["isTryBlock"] = (node.flags & TryBlock) != 0;
+            nodeJson["isThrowingException"] = (node.flags & ThrowsException) != 0;
             
             nodesJson.push_back(nodeJson);
         }
@@ -185,11 +131,11 @@ namespace GraphGenerator {
         // Add edges
         json edgesJson = json::array();
         for (const auto& [nodeID, node] : nodes) {
-            for (int successorID : node.successors) {
+            for (const auto& [successorID, flags] : node.successors) {
                 json edgeJson;
                 edgeJson["source"] = nodeID;
                 edgeJson["target"] = successorID;
-                edgeJson["isExceptionEdge"] = isExceptionEdge(nodeID, successorID);
+                edgeJson["isExceptionEdge"] = (flags & ExceptionEdge) != 0;
                 edgesJson.push_back(edgeJson);
             }
         }
@@ -218,8 +164,90 @@ namespace GraphGenerator {
         return stmtStr;
     }
 
+    llvm::StringRef getStmtSourceText(const clang::Stmt* S, const clang::ASTContext& context) {
+        if (!S) return llvm::StringRef();
+        clang::SourceLocation begin = S->getBeginLoc();
+        clang::SourceLocation end = S->getEndLoc();
+        if (begin.isInvalid() || end.isInvalid() || begin.isMacroID() || end.isMacroID()) {
+            return llvm::StringRef();
+        }
+        const clang::SourceManager& SM = context.getSourceManager();
+        if (SM.getFileID(begin) != SM.getFileID(end)) {
+            return llvm::StringRef();
+        }
+        bool invalid = false;
+        llvm::StringRef text = clang::Lexer::getSourceText(
+            clang::CharSourceRange::getTokenRange(begin, end), SM, context.getLangOpts(), &invalid);
+        return invalid ? llvm::StringRef() : text;
+    }
+
+    // Turns statements into StatementTexts for one graph: source slices where
+    // the statement is spelled contiguously in a file, interned pretty-printed
+    // text otherwise. Each file is registered with the pool once per graph.
+    class StatementTexts {
+    public:
+        StatementTexts(const clang::ASTContext& context, StringPool& strings, LabelMode mode)
+            : m_context(context), m_strings(strings), m_mode(mode) {}
+
+        StatementText text(const clang::Stmt* stmt) {
+            if (m_mode == LabelMode::SourceSlice) {
+                llvm::StringRef spelling = getStmtSourceText(stmt, m_context);
+                if (!spelling.empty()) {
+                    // The offset comes from Clang, relative to the buffer it
+                    // parsed; the SourceFile holds the same bytes but may be
+                    // a copy or an older file with identical text.
+                    const clang::SourceManager& SM = m_context.getSourceManager();
+                    std::pair<clang::FileID, unsigned> location = SM.getDecomposedLoc(stmt->getBeginLoc());
+                    const SourceFile* file = sourceFile(location.first);
+                    size_t end = location.second + spelling.size();
+                    if (file && end <= file->text().size()) {
+                        return StatementText(file, location.second, static_cast<uint32_t>(end));
+                    }
+                }
+            }
+
+            std::string printed;
+            llvm::raw_string_ostream os(printed);
+            stmt->printPretty(os, nullptr, m_context.getPrintingPolicy());
+            return StatementText(m_strings.intern(llvm::StringRef(os.str())));
+        }
+
+    private:
+        // Borrows the buffer Clang parsed when it came from the shared file
+        // cache; anything else (unsaved editor buffers) is copied once.
+        const SourceFile* sourceFile(clang::FileID fileID) {
+            auto it = m_files.find(fileID);
+            if (it != m_files.end()) {
+                return it->second;
+            }
+
+            const clang::SourceManager& SM = m_context.getSourceManager();
+            const SourceFile* file = nullptr;
+            auto entry = SM.getFileEntryRefForID(fileID);
+            std::optional<llvm::MemoryBufferRef> buffer = SM.getBufferOrNone(fileID);
+            if (entry && buffer) {
+                std::string path = entry->getName().str();
+                std::shared_ptr<const llvm::MemoryBuffer> cached =
+                    CFGAnalyzer::SharedFileCache::instance().cachedBuffer(path);
+                llvm::StringRef text = buffer->getBuffer();
+                if (cached && cached->getBufferStart() != text.data()) {
+                    cached.reset();
+                }
+                file = m_strings.addSource(path, text, std::move(cached));
+            }
+            m_files[fileID] = file;
+            return file;
+        }
+
+        const clang::ASTContext& m_context;
+        StringPool& m_strings;
+        LabelMode m_mode;
+        llvm::DenseMap<clang::FileID, const SourceFile*> m_files;
+    };
+
     void extractStatementsFromBlock(const clang::CFGBlock* block, CFGGraph* graph, 
-                                    const QString& filename, const clang::ASTContext* astContext) {
+                                    const QString& filename, const clang::ASTContext* astContext,
+                                    StatementTexts& texts) {
         if (!block || !graph || !astContext) return;
     
         const clang::SourceManager& SM = astContext->getSourceManager();
@@ -229,8 +257,7 @@ namespace GraphGenerator {
         for (const auto& element : *block) {
             if (element.getKind() == clang::CFGElement::Statement) {
                 const clang::Stmt* stmt = element.castAs<clang::CFGStmt>().getStmt();
-                std::string stmtStr = getStmtString(stmt);
-                graph->addStatement(block->getBlockID(), QString::fromStdString(stmtStr));
+                graph->addStatement(block->getBlockID(), texts.text(stmt));
                 
                 // Get source location
                 clang::SourceRange range = stmt->getSourceRange();
@@ -252,10 +279,6 @@ namespace GraphGenerator {
         if (startLine != -1 && endLine != -1) {
             graph->setNodeSourceRange(block->getBlockID(), filename, startLine, endLine);
         }
-    
-        if (block->size() > 5) {
-            graph->markNodeAsExpandable(block->getBlockID());
-        }
     }
 
     void handleTryAndCatch(const clang::CFGBlock* block, CFGGraph* graph, 
@@ -285,10 +308,17 @@ namespace GraphGenerator {
 
     void handleSuccessors(const clang::CFGBlock* block, CFGGraph* graph) {
         int blockID = block->getBlockID();
-
-        for (auto succ = block->succ_begin(); succ != block->succ_end(); ++succ) {
-            if (*succ) {
-                graph->addEdge(blockID, (*succ)->getBlockID());
+        // A two-way conditional lists its true successor first.
+        bool conditional = block->getTerminatorCondition() && block->succ_size() == 2;
+
+        unsigned position = 0;
+        for (auto succ = block->succ_begin(); succ != block->succ_end(); ++succ, ++position) {
+            if (!*succ) continue;
+            int targetID = (*succ)->getBlockID();
+            if (conditional) {
+                graph->setEdgeFlags(blockID, targetID, position == 0 ? TrueBranch : FalseBranch);
+            } else {
+                graph->addEdge(blockID, targetID);
             }
         }
     }
@@ -389,10 +419,12 @@ namespace GraphGenerator {
         return graph;
     }
 
-    std::unique_ptr<CFGGraph> generateCFG(const clang::FunctionDecl* FD) {
+    std::unique_ptr<CFGGraph> generateCFG(const clang::FunctionDecl* FD,
+                                          std::shared_ptr<StringPool> strings,
+                                          LabelMode labelMode) {
         if (!FD || !FD->hasBody()) return nullptr;
         
-        auto graph = std::make_unique<CFGGraph>();
+        auto graph = std::make_unique<CFGGraph>(std::move(strings));
         
         // Get filename
         const clang::SourceManager& SM = FD->getASTContext().getSourceManager();
@@ -410,6 +442,7 @@ namespace GraphGenerator {
         
         // Store ASTContext
         const clang::ASTContext* astContext = &FD->getASTContext();
+        StatementTexts texts(*astContext, *graph->strings(), labelMode);
         
         // Process blocks
         std::map<const clang::Stmt*, clang::CFGBlock*> stmtToBlock;
@@ -423,12 +456,24 @@ namespace GraphGenerator {
             }
         }
         
+        QString functionName = QString::fromStdString(FD->getQualifiedNameAsString());
         for (const auto* block : *cfg) {
             int blockID = block->getBlockID();
-            graph->addNode(blockID, QString("Block %1").arg(blockID));
+            if (block == &cfg->getEntry()) {
+                graph->addNode(blockID, "ENTRY");
+                int line = SM.getSpellingLineNumber(FD->getBeginLoc());
+                graph->setNodeSourceRange(blockID, filename, line, line);
+            } else if (block == &cfg->getExit()) {
+                graph->addNode(blockID, "EXIT");
+                int line = SM.getSpellingLineNumber(FD->getEndLoc());
+                graph->setNodeSourceRange(blockID, filename, line, line);
+            } else {
+                graph->addNode(blockID, QString("Block %1").arg(blockID));
+            }
+            graph->setNodeFunctionName(blockID, functionName);
             
             // Pass ASTContext to extractStatementsFromBlock
-            extractStatementsFromBlock(block, graph.get(), filename, astContext);
+            extractStatementsFromBlock(block, graph.get(), filename, astContext, texts);
             handleTryAndCatch(block, graph.get(), stmtToBlock);
             handleSuccessors(block, graph.get());
         }
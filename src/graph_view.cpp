@@ -0,0 +1,207 @@
+#include "graph_view.h"
+#include "graph_analysis.h"
+
+namespace GraphGenerator {
+
+void CFGGraphView::reset(std::shared_ptr<const FrozenGraph> graph, bool visible) {
+    m_graph = std::move(graph);
+    m_collapsed.clear();
+    m_collapsedComponents.clear();
+    m_foldedInto.clear();
+    if (visible) {
+        showAll();
+    } else {
+        hideAll();
+    }
+}
+
+void CFGGraphView::showAll() {
+    m_complete = true;
+}
+
+void CFGGraphView::hideAll() {
+    m_complete = false;
+    // reset() then resize() keeps the capacity of the bitmap.
+    m_visible.reset();
+    m_visible.resize(m_graph ? m_graph->nodeCount() : 0, false);
+}
+
+void CFGGraphView::materialize() {
+    if (!m_complete) return;
+    m_complete = false;
+    m_visible.resize(m_graph->nodeCount());
+    m_visible.set();
+}
+
+void CFGGraphView::show(uint32_t index) {
+    if (m_complete) return;
+    m_visible.set(index);
+}
+
+void CFGGraphView::hide(uint32_t index) {
+    materialize();
+    m_visible.reset(index);
+}
+
+bool CFGGraphView::showId(int id) {
+    uint32_t index = m_graph ? m_graph->indexOf(id) : FrozenGraph::npos;
+    if (index == FrozenGraph::npos) return false;
+    show(index);
+    return true;
+}
+
+void CFGGraphView::selectFunction(const QString& functionName) {
+    hideAll();
+    if (!m_graph) return;
+    for (uint32_t i = 0; i < m_graph->nodeCount(); ++i) {
+        if (m_graph->functionName(i) == functionName) {
+            m_visible.set(i);
+        }
+    }
+}
+
+void CFGGraphView::collapse(uint32_t region) {
+    if (!m_graph) return;
+    if (m_collapsed.empty()) {
+        m_collapsed.resize(m_graph->regions().size());
+    }
+    m_collapsed.set(region);
+    refold();
+}
+
+void CFGGraphView::expand(uint32_t region) {
+    if (!isCollapsed(region)) return;
+    m_collapsed.reset(region);
+    refold();
+}
+
+void CFGGraphView::collapseAll() {
+    if (!m_graph) return;
+    m_collapsed.resize(m_graph->regions().size());
+    m_collapsed.set();
+    refold();
+}
+
+void CFGGraphView::expandAll() {
+    m_collapsed.reset();
+    m_collapsedComponents.reset();
+    m_foldedInto.clear();
+}
+
+void CFGGraphView::collapseComponent(uint32_t component) {
+    if (!m_graph) return;
+    if (m_collapsedComponents.empty()) {
+        m_collapsedComponents.resize(m_graph->components().size());
+    }
+    m_collapsedComponents.set(component);
+    refold();
+}
+
+void CFGGraphView::expandComponent(uint32_t component) {
+    if (!isComponentCollapsed(component)) return;
+    m_collapsedComponents.reset(component);
+    refold();
+}
+
+void CFGGraphView::collapseCycles() {
+    if (!m_graph) return;
+    const StronglyConnectedComponents& components = m_graph->components();
+    m_collapsedComponents.resize(components.size());
+    for (uint32_t c = 0; c < components.size(); ++c) {
+        if (components.isCyclic(c)) {
+            m_collapsedComponents.set(c);
+        }
+    }
+    refold();
+}
+
+void CFGGraphView::refold() {
+    if (m_collapsed.none() && m_collapsedComponents.none()) {
+        m_foldedInto.clear();
+        return;
+    }
+    m_foldedInto.assign(m_graph->nodeCount(), FrozenGraph::npos);
+    for (int c = m_collapsedComponents.find_first(); c != -1; c = m_collapsedComponents.find_next(c)) {
+        auto members = m_graph->components().members(c);
+        for (uint32_t v : members) {
+            if (v != members[0]) {
+                m_foldedInto[v] = members[0];
+            }
+        }
+    }
+    if (m_collapsed.none()) return;
+
+    const RegionForest& regions = m_graph->regions();
+    // Parents come first, so the outermost collapsed region wins and the
+    // regions inside it need no work.
+    for (int r = m_collapsed.find_first(); r != -1; r = m_collapsed.find_next(r)) {
+        uint32_t entry = regions[r].entry;
+        if (m_foldedInto[entry] != FrozenGraph::npos) continue;
+        for (uint32_t v : regions.nodes(r)) {
+            if (v != entry && m_foldedInto[v] == FrozenGraph::npos) {
+                m_foldedInto[v] = entry;
+            }
+        }
+    }
+}
+
+bool CFGGraphView::containsId(int id) const {
+    uint32_t index = m_graph ? m_graph->indexOf(id) : FrozenGraph::npos;
+    return index != FrozenGraph::npos && contains(index);
+}
+
+size_t CFGGraphView::nodeCount() const {
+    if (!m_graph) return 0;
+    if (m_foldedInto.empty()) {
+        return m_complete ? m_graph->nodeCount() : m_visible.count();
+    }
+    size_t count = 0;
+    for (int i = next(-1); i != -1; i = next(i)) {
+        ++count;
+    }
+    return count;
+}
+
+int CFGGraphView::next(int index) const {
+    int count = static_cast<int>(m_graph->nodeCount());
+    do {
+        if (m_complete) {
+            ++index;
+        } else {
+            index = index < 0 ? m_visible.find_first() : m_visible.find_next(index);
+        }
+        if (index < 0 || index >= count) return -1;
+    } while (foldedInto(index) != FrozenGraph::npos);
+    return index;
+}
+
+CFGGraphView::NodeRange CFGGraphView::nodes() const {
+    int first = m_graph ? next(-1) : -1;
+    return NodeRange(NodeIterator(this, first), NodeIterator(this, -1));
+}
+
+CFGGraphView::SuccessorRange CFGGraphView::successors(uint32_t index) const {
+    FrozenGraph::Range<uint32_t> targets = m_graph->successors(index);
+    uint32_t firstEdge = m_graph->firstEdge(index);
+    return SuccessorRange(
+        SuccessorIterator(this, targets.begin(), targets.begin(), targets.end(), firstEdge),
+        SuccessorIterator(this, targets.begin(), targets.end(), targets.end(), firstEdge));
+}
+
+std::string CFGGraphView::toDot() const {
+    if (!m_graph) return FrozenGraph().toDot();
+    if (m_foldedInto.empty()) {
+        return m_complete ? m_graph->toDot() : m_graph->toDot(m_visible);
+    }
+
+    std::vector<uint32_t> representative(m_graph->nodeCount(), FrozenGraph::npos);
+    for (uint32_t i = 0; i < representative.size(); ++i) {
+        uint32_t into = m_foldedInto[i] == FrozenGraph::npos ? i : m_foldedInto[i];
+        if (m_complete || m_visible.test(into)) {
+            representative[i] = into;
+        }
+    }
+    return m_graph->toDot(representative);
+}
+
+} // namespace GraphGenerator
@@ -185,10 +185,16 @@ void CustomGraphView::addEdge(const QString& from, const QString& to) {
         edge->setData(1, from);    // Store source node ID
         edge->setData(2, to);      // Store target node ID
         
-        m_edges.append(qMakePair(from, to));
+        recordEdge(from, to);
     }
 }
 
+void CustomGraphView::recordEdge(const QString& from, const QString& to) {
+    m_edges.append(qMakePair(from, to));
+    m_successors[from].append(to);
+    m_predecessors[to].append(from);
+}
+
 void CustomGraphView::calculateLevels() {
     m_nodeLevels.clear();
     
@@ -196,22 +202,17 @@ void CustomGraphView::calculateLevels() {
     
     // Find root nodes
     QSet<QString> rootNodes;
-    QSet<QString> allNodes(m_nodes.keys().begin(), m_nodes.keys().end());
-    QSet<QString> nodesWithIncomingEdges;
-    
-    foreach (const auto& edge, m_edges) {
-        nodesWithIncomingEdges.insert(edge.second);
-    }
+    const QList<QString> allNodes = m_nodes.keys();
     
     // Root nodes are those with no incoming edges
     foreach (const QString& nodeId, allNodes) {
-        if (!nodesWithIncomingEdges.contains(nodeId)) {
+        if (!m_predecessors.contains(nodeId)) {
             rootNodes.insert(nodeId);
         }
     }
     
     if (rootNodes.isEmpty()) {
-        rootNodes.insert(*allNodes.begin());
+        rootNodes.insert(allNodes.first());
     }
     
     QQueue<QPair<QString, int>> queue;  // (nodeId, level)
@@ -225,17 +226,20 @@ void CustomGraphView::calculateLevels() {
         QString currentNode = current.first;
         int currentLevel = current.second;
         
-        // Update level if we found a longer path
-        if (!m_nodeLevels.contains(currentNode) || 
-            m_nodeLevels[currentNode] < currentLevel) {
-            m_nodeLevels[currentNode] = currentLevel;
+        // Only a longer path moves a node down; levels are capped at the
+        // node count so cycles terminate
+        if (m_nodeLevels.contains(currentNode) && 
+            m_nodeLevels[currentNode] >= currentLevel) {
+            continue;
+        }
+        m_nodeLevels[currentNode] = currentLevel;
+        if (currentLevel + 1 >= allNodes.size()) {
+            continue;
         }
         
         // Process all outgoing edges
-        foreach (const auto& edge, m_edges) {
-            if (edge.first == currentNode) {
-                queue.enqueue(qMakePair(edge.second, currentLevel + 1));
-            }
+        foreach (const QString& successor, m_successors.value(currentNode)) {
+            queue.enqueue(qMakePair(successor, currentLevel + 1));
         }
     }
     
@@ -391,7 +395,7 @@ void CustomGraphView::parsePlainFormat(const QString& plainOutput) {
                 edge->setData(0, "edge");  // Mark as edge
                 edge->setData(1, fromNode); // Store source
                 edge->setData(2, toNode);   // Store target
-                m_edges.append(qMakePair(fromNode, toNode)); // Store relationship
+                recordEdge(fromNode, toNode); // Store relationship
             }
         }
     }
@@ -818,7 +822,7 @@ void CustomGraphView::parseJson(const QByteArray &jsonData) {
             edgeItem->setData(0, "edge");  // Mark as edge
             edgeItem->setData(1, from);    // Store source
             edgeItem->setData(2, to);      // Store target
-            m_edges.append(qMakePair(from, to)); // Store relationship
+            recordEdge(from, to); // Store relationship
         }
     }
     
@@ -847,6 +851,8 @@ void CustomGraphView::clear()
     }
     m_nodes.clear();
     m_edges.clear();
+    m_successors.clear();
+    m_predecessors.clear();
     m_nodeLevels.clear();
     
     // Reinitialize basic items
@@ -861,6 +867,8 @@ CustomGraphView::~CustomGraphView()
     // Clear containers first
     m_nodes.clear();
     m_edges.clear();
+    m_successors.clear();
+    m_predecessors.clear();
     m_nodeLevels.clear();
     
     // Delete the scene
@@ -1,8 +1,10 @@
 #include "mainwindow.h"
 #include "cfg_analyzer.h"
+#include "graph_analysis.h"
 #include "ui_mainwindow.h"
 #include "visualizer.h"
-#include "node.h"
+#include "worker_pool.h"
+#include "shared_file_cache.h"
 #include "SyntaxHighlighter.h"
 #include <QProgressDialog>
 #include <unordered_set>
@@ -42,6 +44,9 @@
 #include <QGraphicsTextItem>
 #include <QRandomGenerator>
 #include <QMutex>
+#include <QInputDialog>
+#include <QStandardPaths>
+#include <QElapsedTimer>
 #include <clang/Frontend/ASTUnit.h>
 #include <cmath>
 #include <QCheckBox>
@@ -50,6 +55,11 @@
 #include <QOpenGLContext>
 #include <QOpenGLFunctions>
 #include <QMenu>
+#include <QDialog>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QHeaderView>
 #include <QGraphicsItem>
 #include <QGraphicsLineItem>
 #include <QGraphicsEllipseItem>
@@ -60,6 +70,86 @@
 #include <QtWebChannel/QWebChannel>
 #include <QScrollBar>
 
+namespace {
+
+// Hooks the C++ side calls through runJavaScript(); every page that renders
+// a graph includes them, so a missing one is a script error, not a no-op.
+const QLatin1String GraphHighlightStyle(R"(
+        .highlighted {
+            stroke: #FFA500 !important;
+            stroke-width: 3px !important;
+            filter: drop-shadow(0 0 5px rgba(255, 165, 0, 0.7));
+        }
+        .controlled {
+            stroke: #4FC3F7 !important;
+            stroke-width: 2px !important;
+            stroke-dasharray: 4 2;
+        }
+        .on-path {
+            stroke: #FF8C00 !important;
+            stroke-width: 3px !important;
+        }
+)");
+
+const QLatin1String GraphHighlightScript(R"(
+        var highlighted = { node: null, edge: null };
+        var controlled = [];
+        var onPath = [];
+
+        function highlightElement(type, id) {
+            // Clear previous highlight
+            if (highlighted[type]) {
+                highlighted[type].classList.remove('highlighted');
+            }
+            
+            // Apply new highlight
+            var element = document.getElementById(type + id);
+            if (element) {
+                element.classList.add('highlighted');
+                highlighted[type] = element;
+                
+                // Center view if node
+                if (type === 'node') {
+                    element.scrollIntoView({ behavior: 'smooth', block: 'center' });
+                }
+            }
+        }
+
+        // Marks the nodes a highlighted branch decides
+        function highlightControlled(ids) {
+            controlled.forEach(function(element) {
+                element.classList.remove('controlled');
+            });
+            controlled = [];
+            ids.forEach(function(id) {
+                var element = document.getElementById('node' + id);
+                if (element) {
+                    element.classList.add('controlled');
+                    controlled.push(element);
+                }
+            });
+        }
+
+        // Marks the nodes and 'from_to' edges of the highlighted paths
+        function highlightPaths(nodeIds, edgeIds) {
+            onPath.forEach(function(element) {
+                element.classList.remove('on-path');
+            });
+            onPath = [];
+            nodeIds.map(function(id) { return 'node' + id; })
+                .concat(edgeIds.map(function(id) { return 'edge' + id; }))
+                .forEach(function(elementId) {
+                    var element = document.getElementById(elementId);
+                    if (element) {
+                        element.classList.add('on-path');
+                        onPath.push(element);
+                    }
+                });
+        }
+)");
+
+} // namespace
+
 void MainWindow::onEdgeClicked(const QString& fromId, const QString& toId)
 {
     qDebug() << "Edge clicked:" << fromId << "->" << toId;
@@ -70,6 +160,7 @@ void MainWindow::onEdgeClicked(const QString& fromId, const QString& toId)
     if (ok1 && ok2 && m_currentGraph) {
         // Highlight the edge in the graph
         highlightEdge(from, to, QColor("#FFA500")); // Orange
+        m_selectedEdge = qMakePair(from, to);
         
         QString edgeType = m_currentGraph->isExceptionEdge(from, to) ? 
             "Exception Edge" : "Control Flow Edge";
@@ -120,6 +211,15 @@ MainWindow::MainWindow(QWidget *parent) :
     ui->setupUi(this);
     qDebug() << "MainWindow UI setup complete";
 
+    CFGAnalyzer::AnalysisOptions analyzerOptions;
+    analyzerOptions.cacheDir =
+        (QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/cfg-summaries").toStdString();
+    // Only the function inventory is built on analysis; a function's CFG is
+    // built when it is opened from the graph.
+    analyzerOptions.lazyFunctionCFGs = true;
+    m_analyzer.setOptions(analyzerOptions);
+    m_analyzerJobs.setMaxThreadCount(1);
+
     // Verify we're in the main thread
     Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
 
@@ -187,6 +287,19 @@ void MainWindow::setupBasicUI()
     // Setup recent files menu
     m_recentFilesMenu = new QMenu("Recent Files", this);
     ui->menuFile->insertMenu(ui->actionExit, m_recentFilesMenu);
+
+    QAction* analyzeProjectAction = new QAction("Analyze Project...", this);
+    ui->menuFile->insertAction(m_recentFilesMenu->menuAction(), analyzeProjectAction);
+    connect(analyzeProjectAction, &QAction::triggered, this, &MainWindow::onAnalyzeProjectClicked);
+
+    QAction* metricsAction = new QAction("Function Metrics...", this);
+    ui->menuFile->insertAction(m_recentFilesMenu->menuAction(), metricsAction);
+    connect(metricsAction, &QAction::triggered, this, &MainWindow::showFunctionMetrics);
+
+    // Isolates Clang crashes and memory growth from the GUI process
+    m_outOfProcessAction = new QAction("Analyze in Worker Processes", this);
+    m_outOfProcessAction->setCheckable(true);
+    ui->menuFile->insertAction(m_recentFilesMenu->menuAction(), m_outOfProcessAction);
     
     if (!ui->centralwidget->findChild<QListWidget*>("fileListWidget")) {
         QListWidget* fileListWidget = new QListWidget(this);
@@ -474,6 +587,18 @@ void MainWindow::setupConnections()
     connect(ui->searchButton, &QPushButton::clicked, this, &MainWindow::onSearchButtonClicked);
     connect(ui->search, &QLineEdit::textChanged, this, &MainWindow::onSearchTextChanged);
 
+    // Live CFG refresh: edits are analyzed from the editor buffer once typing
+    // pauses, without saving the file.
+    m_liveRefreshTimer = new QTimer(this);
+    m_liveRefreshTimer->setSingleShot(true);
+    m_liveRefreshTimer->setInterval(400);
+    connect(m_liveRefreshTimer, &QTimer::timeout, this, &MainWindow::refreshFunctionUnderCursor);
+    connect(ui->codeEditor, &QTextEdit::textChanged, this, [this]() {
+        if (!m_currentFile.isEmpty() && ui->codeEditor->document()->isModified()) {
+            m_liveRefreshTimer->start();
+        }
+    });
+
     connect(this, &MainWindow::nodeClicked, this, &MainWindow::onNodeClicked);
     
     connect(webView, &QWebEngineView::loadFinished, [this](bool success) {
@@ -631,6 +756,7 @@ bool MainWindow::displayImage(const QString& imagePath) {
         m_graphView->fitInView(scene->sceneRect(), Qt::KeepAspectRatio);
         return true;
     } else if (m_scene) {
+        m_controlledNodes.clear();
         m_scene->clear();
         m_scene->addPixmap(pixmap);
         if (m_graphView) {
@@ -799,7 +925,9 @@ void MainWindow::startTextOnlyMode() {
     
     connect(this, &MainWindow::analysisComplete, this, 
         [this](const CFGAnalyzer::AnalysisResult& result) {
-            ui->reportTextEdit->setPlainText(QString::fromStdString(result.dotOutput));
+            if (result.graph) {
+                ui->reportTextEdit->setPlainText(QString::fromStdString(result.graph->toDot()));
+            }
         });
 };
 
@@ -848,10 +976,11 @@ void MainWindow::onAnalysisComplete(CFGAnalyzer::AnalysisResult result)
     Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
     
     if (result.success) {
-        if (!result.dotOutput.empty()) {
-            m_currentGraph = parseDotToCFG(QString::fromStdString(result.dotOutput));
-            visualizeCFG(m_currentGraph);
+        if (result.graph) {
+            m_currentGraph = std::move(result.graph);
+            visualizeCFG(m_currentGraph, GraphKind::CallGraph);
         }
+        m_metrics = std::move(result.metrics);
         ui->reportTextEdit->setPlainText(QString::fromStdString(result.report));  
     } else {
         QMessageBox::warning(this, "Analysis Failed", 
@@ -895,6 +1024,7 @@ void MainWindow::setupGraphView() {
     qDebug() << "=== Starting graph view setup ===";
     
     if (m_scene) {
+        m_controlledNodes.clear();
         m_scene->clear();
         delete m_scene;
     }
@@ -923,61 +1053,25 @@ void MainWindow::setupGraphView() {
     qDebug() << "Viewport type:" << m_graphView->viewport()->metaObject()->className();
 };
 
-void MainWindow::visualizeCFG(std::shared_ptr<GraphGenerator::CFGGraph> graph) {
+void MainWindow::visualizeCFG(std::shared_ptr<const GraphGenerator::FrozenGraph> graph,
+                              GraphKind kind) {
     if (!graph) {
         qWarning() << "Null graph provided";
         return;
     }
 
     try {
-        QString dotContent = generateInteractiveDot(graph);
         m_currentGraph = graph;
-        
-        // Use QWebEngineView for visualization
-        if (webView) {
-            QString html = QString(R"(
-                <!DOCTYPE html>
-                <html>
-                <head>
-                    <script src="https://cdnjs.cloudflare.com/ajax/libs/viz.js/2.1.2/viz.js"></script>
-                    <script src="https://cdnjs.cloudflare.com/ajax/libs/viz.js/2.1.2/full.render.js"></script>
-                    <style>
-                        body { margin: 0; padding: 0; }
-                        #graph-container { width: 100vw; height: 100vh; }
-                    </style>
-                </head>
-                <body>
-                    <div id="graph-container"></div>
-                    <script>
-                        try {
-                            const viz = new Viz();
-                            viz.renderSVGElement(`%1`)
-                                .then(svg => {
-                                    document.getElementById('graph-container').appendChild(svg);
-                                })
-                                .catch(err => {
-                                    console.error("Graph error:", err);
-                                    showError("Failed to render graph");
-                                    document.getElementById('loading').textContent = "Render failed";
-                                });
-                        } catch(e) {
-                            console.error(e);
-                            document.getElementById('graph-container').innerHTML = 
-                                '<p style="color:red">Error initializing Viz.js</p>';
-                        }
-                    </script>
-                </body>
-                </html>
-            )").arg(dotContent);
-
-            webView->setHtml(html);
-        }
+        m_graphKind = kind;
+        // Same page as every other graph display, so the highlighting hooks
+        // are there.
+        displayGraph(generateInteractiveDot(currentView()));
     } catch (const std::exception& e) {
         qCritical() << "Visualization error:" << e.what();
     }
 };
 
-QString MainWindow::generateInteractiveDot(std::shared_ptr<GraphGenerator::CFGGraph> graph) {
+QString MainWindow::generateInteractiveDot(const GraphGenerator::CFGGraphView& graph) {
     if (!graph) return "digraph G { label=\"Empty Graph\"; empty [shape=plaintext, label=\"No graph available\"]; }";
 
     QString dot;
@@ -988,16 +1082,43 @@ QString MainWindow::generateInteractiveDot(std::shared_ptr<GraphGenerator::CFGGr
     stream << "  node [shape=rectangle, style=filled, fillcolor=lightblue];\n";
     stream << "  edge [arrowsize=0.8];\n\n";
 
-    // Add nodes
-    const auto& nodes = graph->getNodes();
-    for (const auto& [id, node] : nodes) {
-        stream << "  \"" << node.label << "\" [id=\"node" << id << "\"];\n";
+    // Entries of collapsed regions stand in for the nodes folded into them
+    QSet<uint32_t> collapsedEntries;
+    for (uint32_t i = 0; i < graph->nodeCount(); ++i) {
+        if (graph.foldedInto(i) != GraphGenerator::FrozenGraph::npos) {
+            collapsedEntries.insert(graph.foldedInto(i));
+        }
     }
 
-    // Add edges
-    for (const auto& [id, node] : nodes) {
-        for (int successor : node.successors) {
-            stream << "  \"" << node.label << "\" -> \"" << nodes.at(successor).label << "\";\n";
+    // Nodes are named by id: labels are source text, neither unique nor
+    // safe to use unescaped.
+    for (uint32_t i : graph.nodes()) {
+        int id = graph->id(i);
+        stream << "  node" << id << " [id=\"node" << id << "\", label=\""
+               << GraphGenerator::escapeDot(graph->label(i)) << "\"";
+        if (collapsedEntries.contains(i)) {
+            stream << ", shape=folder, xlabel=\"+\"";
+        }
+        stream << "];\n";
+    }
+
+    // Add edges; those leaving a collapsed region start at its entry
+    QSet<QPair<uint32_t, uint32_t>> edges;
+    for (uint32_t i = 0; i < graph->nodeCount(); ++i) {
+        uint32_t from = graph.foldedInto(i) == GraphGenerator::FrozenGraph::npos ? i : graph.foldedInto(i);
+        if (!graph.contains(from)) continue;
+        for (uint32_t successor : graph->successors(i)) {
+            if (!graph.contains(successor) || (from != i && successor == from)) continue;
+            if (edges.contains(qMakePair(from, successor))) continue;
+            edges.insert(qMakePair(from, successor));
+            int fromId = graph->id(from);
+            int toId = graph->id(successor);
+            stream << "  node" << fromId << " -> node" << toId
+                   << " [id=\"edge" << fromId << "_" << toId << "\"";
+            if (from != i) {
+                stream << ", style=dashed";
+            }
+            stream << "];\n";
         }
     }
 
@@ -1032,12 +1153,13 @@ QString MainWindow::generateProgressiveDot(const QString& fullDot, int rootNode)
     }
 
     // Update visibility states
-    if (m_currentRootNode != rootNode) {
+    if (m_currentRootNode != rootNode || m_visibleNodes.graph() != m_currentGraph) {
         m_expandedNodes.clear();
-        m_visibleNodes.clear();
+        m_visibleNodes.reset(m_currentGraph, false);
         m_currentRootNode = rootNode;
     }
-    m_visibleNodes[rootNode] = true;
+    m_visibleNodes.showId(rootNode);
+    auto isVisible = [&](int id) { return id == rootNode || m_visibleNodes.containsId(id); };
 
     stream << "digraph G {\n"
            << "  rankdir=TB;\n"
@@ -1051,7 +1173,7 @@ QString MainWindow::generateProgressiveDot(const QString& fullDot, int rootNode)
         auto match = nodeMatches.next();
         int nodeId = match.captured(1).toInt();
         
-        if (m_visibleNodes[nodeId]) {
+        if (isVisible(nodeId)) {
             QString nodeDef = match.captured(0);
             if (nodeId == rootNode) {
                 nodeDef.replace("]", ", fillcolor=\"#4CAF50\", penwidth=2]");
@@ -1062,11 +1184,12 @@ QString MainWindow::generateProgressiveDot(const QString& fullDot, int rootNode)
 
     for (auto it = adjacencyList.begin(); it != adjacencyList.end(); ++it) {
         int from = it.key();
-        if (!m_visibleNodes[from]) continue;
+        if (!isVisible(from)) continue;
 
         for (int to : it.value()) {
-            if (m_visibleNodes[to]) {
-                stream << "  node" << from << " -> node" << to << ";\n";
+            if (isVisible(to)) {
+                stream << "  node" << from << " -> node" << to
+                       << " [id=\"edge" << from << "_" << to << "\"];\n";
             } else if (m_expandedNodes[from]) {
                 stream << "  node" << to << " [label=\"+\", shape=ellipse, "
                        << "fillcolor=\"#9E9E9E\", tooltip=\"Expand node " << to << "\"];\n";
@@ -1087,10 +1210,10 @@ void MainWindow::startProgressiveVisualization(int rootNode)
 
     // Reset state
     m_expandedNodes.clear();
-    m_visibleNodes.clear();
+    m_visibleNodes.reset(m_currentGraph, false);
     m_currentRootNode = rootNode;
 
-    m_visibleNodes[rootNode] = true;
+    m_visibleNodes.showId(rootNode);
 
     displayProgressiveGraph();
 };
@@ -1105,26 +1228,32 @@ void MainWindow::displayProgressiveGraph()
     stream << "  rankdir=TB;\n";
     stream << "  node [shape=rectangle, style=\"rounded,filled\"];\n\n";
     
+    const auto& graph = *m_currentGraph;
+    if (m_visibleNodes.graph() != m_currentGraph) {
+        m_visibleNodes.reset(m_currentGraph, false);
+        m_visibleNodes.showId(m_currentRootNode);
+    }
+
     // Add visible nodes
-    for (const auto& [id, node] : m_currentGraph->getNodes()) {
-        if (m_visibleNodes[id]) {
-            stream << "  node" << id << " [label=\"" << escapeDotLabel(node.label) << "\"";
-            
-            // Highlight root node
-            if (id == m_currentRootNode) {
-                stream << ", fillcolor=\"#4CAF50\", penwidth=2";
-            }
-            
-            stream << "];\n";
+    for (uint32_t i : m_visibleNodes.nodes()) {
+        int id = graph.id(i);
+        stream << "  node" << id << " [label=\"" << escapeDotLabel(graph.label(i)) << "\"";
+        
+        // Highlight root node
+        if (id == m_currentRootNode) {
+            stream << ", fillcolor=\"#4CAF50\", penwidth=2";
         }
+        
+        stream << "];\n";
     }
 
-    for (const auto& [id, node] : m_currentGraph->getNodes()) {
-        if (!m_visibleNodes[id]) continue;
-
-        for (int succ : node.successors) {
-            if (m_visibleNodes[succ]) {
-                stream << "  node" << id << " -> node" << succ << ";\n";
+    for (uint32_t i : m_visibleNodes.nodes()) {
+        int id = graph.id(i);
+        for (uint32_t successor : graph.successors(i)) {
+            int succ = graph.id(successor);
+            if (m_visibleNodes.contains(successor)) {
+                stream << "  node" << id << " -> node" << succ
+                       << " [id=\"edge" << id << "_" << succ << "\"];\n";
             } else if (m_expandedNodes[id]) {
                 stream << "  node" << succ << " [label=\"+\", shape=ellipse, fillcolor=\"#9E9E9E\"];\n";
                 stream << "  node" << id << " -> node" << succ << " [style=dashed, color=gray];\n";
@@ -1142,11 +1271,13 @@ void MainWindow::handleProgressiveNodeClick(const QString& nodeId) {
     int id = nodeId.toInt(&ok);
     if (!ok || !m_currentGraph) return;
 
-    const auto& nodes = m_currentGraph->getNodes();
-    auto it = nodes.find(id);
-    if (it != nodes.end()) {
-        for (int succ : it->second.successors) {
-            m_visibleNodes[succ] = true;
+    if (m_visibleNodes.graph() != m_currentGraph) {
+        m_visibleNodes.reset(m_currentGraph, false);
+    }
+    uint32_t index = m_currentGraph->indexOf(id);
+    if (index != GraphGenerator::FrozenGraph::npos) {
+        for (uint32_t successor : m_currentGraph->successors(index)) {
+            m_visibleNodes.show(successor);
         }
     }
     displayProgressiveGraph();
@@ -1166,16 +1297,12 @@ QString MainWindow::generateInteractiveGraphHtml(const QString& dotContent) cons
     <script src="https://cdnjs.cloudflare.com/ajax/libs/viz.js/2.1.2/viz.js"></script>
     <script src="https://cdnjs.cloudflare.com/ajax/libs/viz.js/2.1.2/full.render.js"></script>
     <style>
-        body { margin:0; background:#2D2D2D; }
+        body { margin:0; background:%1; }
         #graph-container { width:100%; height:100%; }
         .node:hover { stroke-width:2px; cursor:pointer; }
         .expanded-node { fill: #ffffcc; stroke-width:2px; }
         .error-message { color: red; padding: 20px; text-align: center; }
-        .highlighted {
-            stroke: #FFA500 !important;
-            stroke-width: 3px !important;
-            filter: drop-shadow(0 0 5px rgba(255, 165, 0, 0.7));
-        }
+%3
     </style>
 </head>
 <body>
@@ -1184,7 +1311,6 @@ QString MainWindow::generateInteractiveGraphHtml(const QString& dotContent) cons
     <script>
         // Safe reference to bridge
         var bridge = null;
-        var highlighted = { node: null, edge: null };
         var collapsedNodes = {};
         var graphData = {};
 
@@ -1255,26 +1381,7 @@ QString MainWindow::generateInteractiveGraphHtml(const QString& dotContent) cons
                 }
             }
         }
-        
-        function highlightElement(type, id) {
-            // Clear previous highlight
-            if (highlighted[type]) {
-                highlighted[type].classList.remove('highlighted');
-            }
-            
-            // Apply new highlight
-            var element = document.getElementById(type + id);
-            if (element) {
-                element.classList.add('highlighted');
-                highlighted[type] = element;
-                
-                // Center view if node
-                if (type === 'node') {
-                    element.scrollIntoView({ behavior: 'smooth', block: 'center' });
-                }
-            }
-        }
-
+%4
         // Main graph rendering
         const viz = new Viz();
         const dot = `%2`;
@@ -1335,13 +1442,13 @@ QString MainWindow::generateInteractiveGraphHtml(const QString& dotContent) cons
     </script>
 </body>
 </html>
-    )").arg(m_currentTheme.backgroundColor.name())
-      .arg(escapedDotContent);
+    )").arg(m_currentTheme.backgroundColor.name(), escapedDotContent,
+            GraphHighlightStyle, GraphHighlightScript);
     
     return html;
 }
 
-std::string MainWindow::generateValidDot(std::shared_ptr<GraphGenerator::CFGGraph> graph) 
+std::string MainWindow::generateValidDot(const GraphGenerator::CFGGraphView& graph) 
 {
     QString dotContent;
     QTextStream stream(&dotContent);
@@ -1362,10 +1469,10 @@ std::string MainWindow::generateValidDot(std::shared_ptr<GraphGenerator::CFGGrap
            << "  node [shape=rectangle, style=filled, fillcolor=lightgray];\n\n";
 
     // Add nodes
-    for (const auto& [id, node] : graph->getNodes()) {
-        stream << "  node" << id << " [label=\"";
+    for (uint32_t i : graph.nodes()) {
+        stream << "  node" << graph->id(i) << " [label=\"";
         QString escapedLabel;
-        for (const QChar& c : node.label) {
+        for (const QChar& c : graph->label(i)) {
             switch (c.unicode()) {
                 case '"':  escapedLabel += "\\\""; break;
                 case '\\': escapedLabel += "\\\\"; break;
@@ -1384,10 +1491,11 @@ std::string MainWindow::generateValidDot(std::shared_ptr<GraphGenerator::CFGGrap
         }
         stream << escapedLabel << "\"";
         // Add node attributes
-        if (graph->isNodeTryBlock(id)) {
+        GraphGenerator::NodeFlags flags = graph->nodeFlags(i);
+        if (flags & GraphGenerator::TryBlock) {
             stream << ", shape=ellipse, fillcolor=lightblue";
         }
-        if (graph->isNodeThrowingException(id)) {
+        if (flags & GraphGenerator::ThrowsException) {
             stream << ", color=red, fillcolor=pink";
         }
         
@@ -1395,13 +1503,15 @@ std::string MainWindow::generateValidDot(std::shared_ptr<GraphGenerator::CFGGrap
     }
 
     // Add edges
-    for (const auto& [id, node] : graph->getNodes()) {
-        for (int successor : node.successors) {
-            stream << "  node" << id << " -> node" << successor;
-            if (graph->isExceptionEdge(id, successor)) {
-                stream << " [color=red, style=dashed]";
+    for (uint32_t i : graph.nodes()) {
+        auto successors = graph.successors(i);
+        for (auto it = successors.begin(); it != successors.end(); ++it) {
+            stream << "  node" << graph->id(i) << " -> node" << graph->id(*it)
+                   << " [id=\"edge" << graph->id(i) << "_" << graph->id(*it) << "\"";
+            if (graph->edgeFlags(it.edge()) & GraphGenerator::ExceptionEdge) {
+                stream << ", color=red, style=dashed";
             }
-            stream << ";\n";
+            stream << "];\n";
         }
     }
 
@@ -1445,17 +1555,21 @@ void MainWindow::onVisualizationError(const QString& error) {
 void MainWindow::showEdgeContextMenu(const QPoint& pos) {
     QMenu menu;
     menu.addAction("Highlight Path", this, [this](){
-        statusBar()->showMessage("Path highlighting not implemented yet", 2000);
+        if (m_selectedEdge.first >= 0) {
+            highlightPathThrough(m_selectedEdge.first, m_selectedEdge.second);
+        } else {
+            highlightPaths(-1, -1, 3);
+        }
     });
     menu.exec(m_graphView->mapToGlobal(pos));
 };
 
-std::shared_ptr<GraphGenerator::CFGGraph> MainWindow::parseDotToCFG(const QString& dotContent) {
-    auto graph = std::make_shared<GraphGenerator::CFGGraph>();
+std::shared_ptr<const GraphGenerator::FrozenGraph> MainWindow::parseDotToCFG(const QString& dotContent) {
+    auto graph = std::make_unique<GraphGenerator::CFGGraph>();
     
     if (dotContent.isEmpty()) {
         qWarning("Empty DOT content provided");
-        return graph;
+        return graph->freeze();
     }
     qDebug() << "DOT content sample:" << dotContent.left(200) << "...";
     QStringList lines = dotContent.split('\n');
@@ -1466,7 +1580,7 @@ std::shared_ptr<GraphGenerator::CFGGraph> MainWindow::parseDotToCFG(const QStrin
     
     if (!nodeRegex.isValid() || !edgeRegex.isValid()) {
         qWarning() << "Invalid regex patterns";
-        return graph;
+        return graph->freeze();
     }
 
     QMap<QString, int> nodeNameToId;
@@ -1500,7 +1614,7 @@ std::shared_ptr<GraphGenerator::CFGGraph> MainWindow::parseDotToCFG(const QStrin
         for (int i = 0; i < qMin(10, lines.size()); i++) {
             qDebug() << "Line" << i << ":" << lines[i];
         }
-        return graph;
+        return graph->freeze();
     }
 
     // Second pass: create all edges
@@ -1519,7 +1633,10 @@ std::shared_ptr<GraphGenerator::CFGGraph> MainWindow::parseDotToCFG(const QStrin
         }
     }
 
-    return graph;
+    GraphGenerator::GraphArena::Stats arena = graph->arenaStats();
+    qDebug() << "Parsed graph:" << arena.allocations << "allocations from"
+             << arena.blocks << "arena blocks";
+    return graph->freeze();
 };
 
 QString MainWindow::parseNodeAttributes(const QString& attributes) {
@@ -1811,7 +1928,8 @@ void MainWindow::visualizeCurrentGraph() {
     if (!m_currentGraph) return;
 
     // Load into web view
-    std::string dot = Visualizer::generateDotRepresentation(m_currentGraph.get());
+    std::string dot = Visualizer::generateDotRepresentation(
+        m_currentGraph.get(), true, false, m_highlightedPaths);
     QString html = QString(R"(
 <!DOCTYPE html>
 <html>
@@ -1825,17 +1943,14 @@ void MainWindow::visualizeCurrentGraph() {
         .node:hover { stroke-width:2px; cursor:pointer; }
         .expanded-node { fill: #ffffcc; stroke-width:2px; }
         .error-message { color: red; padding: 20px; text-align: center; }
-        .highlighted {
-            stroke: #FFA500 !important;
-            stroke-width: 3px !important;
-            filter: drop-shadow(0 0 5px rgba(255, 165, 0, 0.7));
-        }
+%2
     </style>
 </head>
 <body>
     <div id="graph-container"></div>
     <script src="qrc:/qtwebchannel/qwebchannel.js"></script>
     <script>
+%3
         new QWebChannel(qt.webChannelTransport, function(channel) {
             window.bridge = channel.objects.bridge;
         });
@@ -1874,7 +1989,7 @@ void MainWindow::visualizeCurrentGraph() {
     </script>
 </body>
 </html>
-    )").arg(QString::fromStdString(dot));
+    )").arg(QString::fromStdString(dot), GraphHighlightStyle, GraphHighlightScript);
     webView->setHtml(html);
     connect(webView, &QWebEngineView::loadFinished, [this](bool success) {
         if (success) {
@@ -1908,17 +2023,36 @@ void MainWindow::highlightNode(int nodeId, const QColor& color)
     
     // Reset previous highlighting
     resetHighlighting();
+
+    // When the node is a branch, also mark the nodes it controls
+    QSet<int> controlledIds;
+    QStringList controlledList;
+    if (m_currentGraph) {
+        uint32_t index = m_currentGraph->indexOf(nodeId);
+        if (index != GraphGenerator::FrozenGraph::npos) {
+            for (uint32_t dependent : m_currentGraph->controlDependence().dependents(index)) {
+                int id = m_currentGraph->id(dependent);
+                if (id != nodeId) {
+                    controlledIds.insert(id);
+                    controlledList << QString::number(id);
+                }
+            }
+        }
+    }
     
     if (webView && webView->isVisible()) {
         webView->page()->runJavaScript(
-            QString("highlightElement('node', '%1');").arg(nodeId)
+            QString("highlightElement('node', '%1');"
+                    "highlightControlled([%2]);")
+                .arg(nodeId).arg(controlledList.join(','))
         );
     }
 
     foreach (QGraphicsItem* item, m_graphView->scene()->items()) {
         if (item->data(MainWindow::NodeItemType).toInt() == 1) {
             if (auto ellipse = qgraphicsitem_cast<QGraphicsEllipseItem*>(item)) {
-                if (item->data(MainWindow::NodeIdKey).toInt() == nodeId) {
+                int id = item->data(MainWindow::NodeIdKey).toInt();
+                if (id == nodeId) {
                     QPen pen = ellipse->pen();
                     pen.setWidth(3);
                     pen.setColor(Qt::darkBlue);
@@ -1928,7 +2062,16 @@ void MainWindow::highlightNode(int nodeId, const QColor& color)
                     ellipse->setBrush(brush);
                     m_highlightNode = item;
                     m_graphView->centerOn(item);
-                    break;
+                } else if (controlledIds.contains(id)) {
+                    QPen pen = ellipse->pen();
+                    pen.setWidth(2);
+                    pen.setStyle(Qt::DashLine);
+                    pen.setColor(Qt::darkBlue);
+                    ellipse->setPen(pen);
+                    QBrush brush = ellipse->brush();
+                    brush.setColor(color.lighter(150));
+                    ellipse->setBrush(brush);
+                    m_controlledNodes.append(item);
                 }
             }
         }
@@ -1980,6 +2123,24 @@ void MainWindow::resetHighlighting()
         m_highlightNode = nullptr;
     }
 
+    for (QGraphicsItem* item : m_controlledNodes) {
+        if (auto ellipse = qgraphicsitem_cast<QGraphicsEllipseItem*>(item)) {
+            ellipse->setPen(QPen(Qt::black, 1));
+            ellipse->setBrush(QBrush(Qt::lightGray));
+        }
+    }
+    m_controlledNodes.clear();
+
+    for (QGraphicsItem* item : m_pathItems) {
+        if (auto ellipse = qgraphicsitem_cast<QGraphicsEllipseItem*>(item)) {
+            ellipse->setPen(QPen(Qt::black, 1));
+        } else if (auto line = qgraphicsitem_cast<QGraphicsLineItem*>(item)) {
+            line->setPen(QPen(Qt::black, 1));
+        }
+    }
+    m_pathItems.clear();
+    m_highlightedPaths.clear();
+
     if (m_highlightEdge) {
         if (auto line = qgraphicsitem_cast<QGraphicsLineItem*>(m_highlightEdge)) {
             QPen pen = line->pen();
@@ -1991,6 +2152,194 @@ void MainWindow::resetHighlighting()
     }
 };
 
+uint32_t MainWindow::pathEnd(uint32_t start, bool forward) const
+{
+    // The exit below start, or the entry above it. Clang numbers the exit
+    // block lowest and the entry highest, which settles ties.
+    const auto& graph = *m_currentGraph;
+    std::vector<char> seen(graph.nodeCount(), 0);
+    std::vector<uint32_t> worklist{start};
+    seen[start] = 1;
+    uint32_t end = GraphGenerator::FrozenGraph::npos;
+    while (!worklist.empty()) {
+        uint32_t node = worklist.back();
+        worklist.pop_back();
+        auto neighbours = forward ? graph.successors(node) : graph.predecessors(node);
+        if (neighbours.empty() &&
+            (end == GraphGenerator::FrozenGraph::npos || (forward ? node < end : node > end))) {
+            end = node;
+        }
+        for (uint32_t neighbour : neighbours) {
+            if (!seen[neighbour]) {
+                seen[neighbour] = 1;
+                worklist.push_back(neighbour);
+            }
+        }
+    }
+    return end;
+};
+
+GraphGenerator::PathEnumerator::Options MainWindow::pathOptions(size_t maxPaths) const
+{
+    GraphGenerator::PathEnumerator::Options options;
+    options.maxPaths = maxPaths;
+    options.maxSteps = PathSearchSteps;
+    if (!m_edgeWeights.isEmpty()) {
+        // m_edgeWeights is keyed by node ids; resolve it per edge index once
+        const auto& graph = *m_currentGraph;
+        auto weights = std::make_shared<std::vector<double>>(graph.edgeCount(), 1.0);
+        for (uint32_t i = 0; i < graph.nodeCount(); ++i) {
+            uint32_t edge = graph.firstEdge(i);
+            for (uint32_t target : graph.successors(i)) {
+                float weight = m_edgeWeights.value(qMakePair(graph.id(i), graph.id(target)), 1.0f);
+                (*weights)[edge++] = std::max(0.0f, weight);
+            }
+        }
+        options.weight = [weights](uint32_t edge) { return (*weights)[edge]; };
+    }
+    return options;
+};
+
+QString MainWindow::describePath(const GraphGenerator::PathEnumerator::Path& path) const
+{
+    QStringList ids;
+    for (uint32_t node : path.nodes) {
+        ids << QString::number(m_currentGraph->id(node));
+    }
+    return QString("(weight %1): %2").arg(path.weight).arg(ids.join(" → "));
+};
+
+bool MainWindow::highlightPaths(int fromId, int toId, size_t maxPaths)
+{
+    if (!m_currentGraph || m_currentGraph->empty()) return false;
+    const auto& graph = *m_currentGraph;
+    const uint32_t npos = GraphGenerator::FrozenGraph::npos;
+
+    if (fromId < 0 && toId < 0) {
+        fromId = findEntryNode();
+    }
+    uint32_t from = fromId < 0 ? npos : graph.indexOf(fromId);
+    uint32_t to = toId < 0 ? npos : graph.indexOf(toId);
+    if (from == npos && to != npos) {
+        from = pathEnd(to, false);
+    } else if (to == npos && from != npos) {
+        to = pathEnd(from, true);
+    }
+    if (from == npos || to == npos) {
+        statusBar()->showMessage("No entry or exit to trace paths between", 3000);
+        return false;
+    }
+
+    GraphGenerator::PathEnumerator paths(graph, from, to, pathOptions(maxPaths));
+    GraphGenerator::PathEnumerator::Path path;
+    std::vector<int> ids;
+    QStringList descriptions;
+    while (paths.next(path)) {
+        Visualizer::appendPath(ids, graph, path);
+        descriptions << QString("Path %1 %2").arg(paths.count()).arg(describePath(path));
+    }
+    if (ids.empty()) {
+        statusBar()->showMessage(QString("No path from %1 to %2%3")
+            .arg(graph.id(from)).arg(graph.id(to))
+            .arg(paths.truncated() ? " within the search limit" : ""), 3000);
+        return false;
+    }
+
+    showHighlightedPaths(std::move(ids), descriptions);
+    statusBar()->showMessage(QString("%1 shortest path(s) from %2 to %3%4")
+        .arg(paths.count()).arg(graph.id(from)).arg(graph.id(to))
+        .arg(paths.truncated() ? ", more not shown" : ""), 5000);
+    return true;
+};
+
+bool MainWindow::highlightPathThrough(int fromId, int toId)
+{
+    if (!m_currentGraph) return false;
+    const auto& graph = *m_currentGraph;
+    uint32_t from = graph.indexOf(fromId);
+    uint32_t to = graph.indexOf(toId);
+    if (from == GraphGenerator::FrozenGraph::npos || to == GraphGenerator::FrozenGraph::npos ||
+        graph.edgeIndex(from, to) == GraphGenerator::FrozenGraph::npos) {
+        statusBar()->showMessage("The selected edge is not in the current graph", 3000);
+        return false;
+    }
+
+    // Shortest entry -> from, then the edge, then shortest to -> exit
+    GraphGenerator::PathEnumerator::Path before, after;
+    GraphGenerator::PathEnumerator toEdge(graph, pathEnd(from, false), from, pathOptions(1));
+    GraphGenerator::PathEnumerator fromEdge(graph, to, pathEnd(to, true), pathOptions(1));
+    if (!toEdge.next(before) || !fromEdge.next(after)) {
+        statusBar()->showMessage(QString("No entry-to-exit path through %1 → %2 within the search limit")
+            .arg(fromId).arg(toId), 3000);
+        return false;
+    }
+
+    GraphGenerator::PathEnumerator::Path path;
+    path.nodes = before.nodes;
+    path.nodes.insert(path.nodes.end(), after.nodes.begin(), after.nodes.end());
+    auto weight = pathOptions(1).weight;
+    path.weight = before.weight + after.weight + (weight ? weight(graph.edgeIndex(from, to)) : 1.0);
+
+    std::vector<int> ids;
+    Visualizer::appendPath(ids, graph, path);
+    showHighlightedPaths(std::move(ids),
+        QStringList(QString("Path through %1 → %2 %3").arg(fromId).arg(toId).arg(describePath(path))));
+    statusBar()->showMessage(QString("Shortest path through %1 → %2 highlighted").arg(fromId).arg(toId), 5000);
+    return true;
+};
+
+void MainWindow::showHighlightedPaths(std::vector<int> paths, const QStringList& descriptions)
+{
+    resetHighlighting();
+    m_highlightedPaths = std::move(paths);
+
+    QSet<int> nodeIds;
+    QSet<QPair<int, int>> edgeIds;
+    QStringList nodeList, edgeList;
+    int previous = Visualizer::PathSeparator;
+    for (int id : m_highlightedPaths) {
+        if (id != Visualizer::PathSeparator) {
+            if (!nodeIds.contains(id)) {
+                nodeIds.insert(id);
+                nodeList << QString::number(id);
+            }
+            if (previous != Visualizer::PathSeparator && !edgeIds.contains(qMakePair(previous, id))) {
+                edgeIds.insert(qMakePair(previous, id));
+                edgeList << QString("'%1_%2'").arg(previous).arg(id);
+            }
+        }
+        previous = id;
+    }
+
+    if (webView && webView->isVisible()) {
+        webView->page()->runJavaScript(
+            QString("highlightPaths([%1], [%2]);")
+                .arg(nodeList.join(',')).arg(edgeList.join(',')));
+    }
+
+    if (m_scene) {
+        const QColor pathColor("#FF8C00");
+        for (QGraphicsItem* item : m_scene->items()) {
+            if (item->data(NodeItemType).toInt() == 1) {
+                auto ellipse = qgraphicsitem_cast<QGraphicsEllipseItem*>(item);
+                if (ellipse && nodeIds.contains(item->data(NodeIdKey).toInt())) {
+                    ellipse->setPen(QPen(pathColor, 2));
+                    m_pathItems.append(item);
+                }
+            } else if (item->data(EdgeItemType).toInt() == 1) {
+                auto line = qgraphicsitem_cast<QGraphicsLineItem*>(item);
+                QPair<int, int> edge(item->data(EdgeFromKey).toInt(), item->data(EdgeToKey).toInt());
+                if (line && edgeIds.contains(edge)) {
+                    line->setPen(QPen(pathColor, 3));
+                    m_pathItems.append(item);
+                }
+            }
+        }
+    }
+
+    ui->reportTextEdit->append("\n" + descriptions.join('\n'));
+};
+
 void MainWindow::expandNode(const QString& nodeIdStr)
 {
     bool ok;
@@ -1998,36 +2347,120 @@ void MainWindow::expandNode(const QString& nodeIdStr)
     if (!ok || !m_currentGraph) return;
 
     m_expandedNodes[nodeId] = true;
-    const auto& nodes = m_currentGraph->getNodes();
-    auto it = nodes.find(nodeId);
-    if (it != nodes.end()) {
-        for (int succ : it->second.successors) {
-            m_visibleNodes[succ] = true;
+    if (m_visibleNodes.graph() != m_currentGraph) {
+        m_visibleNodes.reset(m_currentGraph, false);
+    }
+    uint32_t index = m_currentGraph->indexOf(nodeId);
+    if (index != GraphGenerator::FrozenGraph::npos) {
+        for (uint32_t successor : m_currentGraph->successors(index)) {
+            m_visibleNodes.show(successor);
         }
     }
     displayGraph(m_currentDotContent, true, m_currentRootNode);
 };
 
-int MainWindow::findEntryNode() {
-    if (!m_currentGraph) return -1;
+void MainWindow::collapseNode(int nodeId)
+{
+    setRegionCollapsed(nodeId, true);
+};
 
-    const auto& nodes = m_currentGraph->getNodes();
-    if (nodes.empty()) return -1;
+const GraphGenerator::CFGGraphView& MainWindow::regionView()
+{
+    if (m_regionView.graph() != m_currentGraph) {
+        m_regionView.reset(m_currentGraph);
+        m_regionView.collapseAll();
+        if (m_currentGraph) {
+            const GraphGenerator::RegionForest& regions = m_currentGraph->regions();
+            for (uint32_t r = 0; r < regions.size(); ++r) {
+                if (m_expandedRegions.contains(m_currentGraph->id(regions[r].entry))) {
+                    m_regionView.expand(r);
+                }
+            }
+        }
+    }
+    return m_regionView;
+};
 
-    std::unordered_set<int> hasIncomingEdges;
-    for (const auto& [id, node] : nodes) {
-        for (int successor : node.successors) {
-            hasIncomingEdges.insert(successor);
+const GraphGenerator::CFGGraphView& MainWindow::callGraphView()
+{
+    if (m_callGraphView.graph() != m_currentGraph) {
+        m_callGraphView.reset(m_currentGraph);
+        m_callGraphView.collapseCycles();
+        if (m_currentGraph) {
+            const auto& components = m_currentGraph->components();
+            for (uint32_t c = 0; c < components.size(); ++c) {
+                if (components.isCyclic(c) &&
+                    m_expandedComponents.contains(m_currentGraph->id(components.members(c)[0]))) {
+                    m_callGraphView.expandComponent(c);
+                }
+            }
         }
     }
+    return m_callGraphView;
+};
+
+const GraphGenerator::CFGGraphView& MainWindow::currentView()
+{
+    return m_graphKind == GraphKind::CallGraph ? callGraphView() : regionView();
+};
+
+bool MainWindow::setComponentCollapsed(int nodeId, bool collapsed)
+{
+    if (!m_currentGraph || m_graphKind != GraphKind::CallGraph ||
+        m_callGraphView.graph() != m_currentGraph) return false;
+    uint32_t index = m_currentGraph->indexOf(nodeId);
+    if (index == GraphGenerator::FrozenGraph::npos) return false;
+    const auto& components = m_currentGraph->components();
+    uint32_t component = components.componentOf(index);
+    if (!components.isCyclic(component)) return false;
+
+    if (m_callGraphView.isComponentCollapsed(component) == collapsed) return false;
+    int representative = m_currentGraph->id(components.members(component)[0]);
+    if (collapsed) {
+        m_callGraphView.collapseComponent(component);
+        m_expandedComponents.remove(representative);
+    } else {
+        m_callGraphView.expandComponent(component);
+        m_expandedComponents.insert(representative);
+    }
+    visualizeCFG(m_currentGraph, m_graphKind);
+    return true;
+};
 
-    for (const auto& [id, node] : nodes) {
-        if (hasIncomingEdges.find(id) == hasIncomingEdges.end()) {
-            return id;
+bool MainWindow::setRegionCollapsed(int nodeId, bool collapsed)
+{
+    if (!m_currentGraph || m_graphKind != GraphKind::ControlFlow) return false;
+    uint32_t index = m_currentGraph->indexOf(nodeId);
+    if (index == GraphGenerator::FrozenGraph::npos) return false;
+    uint32_t region = m_currentGraph->regions().headedBy(index);
+    if (region == GraphGenerator::FrozenGraph::npos) return false;
+
+    regionView();
+    if (m_regionView.isCollapsed(region) == collapsed) return false;
+    if (collapsed) {
+        m_regionView.collapse(region);
+        m_expandedRegions.remove(nodeId);
+    } else {
+        m_regionView.expand(region);
+        m_expandedRegions.insert(nodeId);
+    }
+    visualizeCFG(m_currentGraph, m_graphKind);
+    return true;
+};
+
+int MainWindow::findEntryNode() {
+    if (!m_currentGraph) return -1;
+
+    const auto& graph = *m_currentGraph;
+    if (graph.empty()) return -1;
+
+    for (uint32_t i = 0; i < graph.nodeCount(); ++i) {
+        if (graph.predecessors(i).empty()) {
+            return graph.id(i);
         }
     }
 
-    return nodes.begin()->first;
+    return graph.id(0);
 };
 
 void MainWindow::selectNode(int nodeId) {
@@ -2057,12 +2490,18 @@ void MainWindow::selectNode(int nodeId) {
         report += QString("Function: %1\n").arg(nodeInfo.functionName);
     }
     
+    const auto& graph = *m_currentGraph;
+    uint32_t index = graph.indexOf(nodeId);
+
     report += "\n=== Called By ===\n";
     bool hasIncoming = false;
-    for (const auto& [otherId, otherNode] : m_currentGraph->getNodes()) {
-        if (std::find(otherNode.successors.begin(), otherNode.successors.end(), nodeId) != otherNode.successors.end()) {
+    if (index != GraphGenerator::FrozenGraph::npos) {
+        auto predecessors = graph.predecessors(index);
+        auto inEdges = graph.predecessorEdges(index);
+        for (size_t k = 0; k < predecessors.size(); ++k) {
             hasIncoming = true;
-            QString edgeType = m_currentGraph->isExceptionEdge(otherId, nodeId) ? 
+            int otherId = graph.id(predecessors[k]);
+            QString edgeType = graph.edgeFlags(inEdges[k]) & GraphGenerator::ExceptionEdge ?
                 " (exception path)" : " (normal flow)";
             if (m_nodeInfoMap.contains(otherId)) {
                 const auto& caller = m_nodeInfoMap[otherId];
@@ -2078,11 +2517,11 @@ void MainWindow::selectNode(int nodeId) {
     }
 
     report += "\n=== Calls To ===\n";
-    const auto& nodes = m_currentGraph->getNodes();
-    auto currentNode = nodes.find(nodeId);
-    if (currentNode != nodes.end() && !currentNode->second.successors.empty()) {
-        for (int successor : currentNode->second.successors) {
-            QString edgeType = m_currentGraph->isExceptionEdge(nodeId, successor) ? 
+    if (index != GraphGenerator::FrozenGraph::npos && !graph.successors(index).empty()) {
+        uint32_t edge = graph.firstEdge(index);
+        for (uint32_t target : graph.successors(index)) {
+            int successor = graph.id(target);
+            QString edgeType = graph.edgeFlags(edge++) & GraphGenerator::ExceptionEdge ?
                 " (exception path)" : " (normal flow)";
             if (m_nodeInfoMap.contains(successor)) {
                 const auto& callee = m_nodeInfoMap[successor];
@@ -2150,6 +2589,7 @@ void MainWindow::handleEdgeClick(const QString& fromId, const QString& toId) {
     if (ok1 && ok2 && m_currentGraph) {
         // Highlight the edge in the graph
         highlightEdge(from, to, QColor("#FFA500")); // Orange
+        m_selectedEdge = qMakePair(from, to);
         
         QString edgeType = m_currentGraph->isExceptionEdge(from, to) ? 
             "Exception Edge" : "Control Flow Edge";
@@ -2268,12 +2708,16 @@ void MainWindow::onNodeExpanded(const QString& nodeId) {
 
     bool ok;
     int id = nodeId.toInt(&ok);
-    if (!ok || !m_currentGraph->isNodeExpandable(id)) return;
+    if (!ok || !(setRegionCollapsed(id, false) || setComponentCollapsed(id, false))) return;
 
     statusBar()->showMessage(QString("Expanded node %1").arg(nodeId), 2000);
 };
 
 void MainWindow::onNodeCollapsed(const QString& nodeId) {
+    bool ok;
+    int id = nodeId.toInt(&ok);
+    if (!ok || !(setRegionCollapsed(id, true) || setComponentCollapsed(id, true))) return;
+
     ui->reportTextEdit->clear();
     statusBar()->showMessage(QString("Collapsed node %1").arg(nodeId), 2000);
 };
@@ -2376,6 +2820,48 @@ void MainWindow::showNodeContextMenu(const QPoint& pos) {
                 highlightCodeSection(m_nodeInfoMap[id].startLine, m_nodeInfoMap[id].endLine);
             }
         });
+
+        bool ok = false;
+        int id = nodeId.toInt(&ok);
+        if (ok && m_currentGraph) {
+            uint32_t index = m_currentGraph->indexOf(id);
+            if (index != GraphGenerator::FrozenGraph::npos &&
+                m_functionNames.contains(m_currentGraph->label(index))) {
+                QString functionName = m_currentGraph->label(index);
+                menu.addAction("Show Function CFG", [this, functionName]() {
+                    visualizeFunction(functionName);
+                });
+            }
+            // Region folding applies to the CFG views built on m_regionView
+            uint32_t region = GraphGenerator::FrozenGraph::npos;
+            if (index != GraphGenerator::FrozenGraph::npos && m_regionView.graph() == m_currentGraph) {
+                region = m_currentGraph->regions().headedBy(index);
+            }
+            if (region != GraphGenerator::FrozenGraph::npos) {
+                bool collapsed = m_regionView.isCollapsed(region);
+                menu.addAction(collapsed ? "Expand Region" : "Collapse Region", [this, id, collapsed]() {
+                    setRegionCollapsed(id, !collapsed);
+                });
+            }
+            if (index != GraphGenerator::FrozenGraph::npos && m_callGraphView.graph() == m_currentGraph) {
+                uint32_t component = m_currentGraph->components().componentOf(index);
+                if (m_currentGraph->components().isCyclic(component)) {
+                    bool collapsed = m_callGraphView.isComponentCollapsed(component);
+                    menu.addAction(collapsed ? "Expand Call Cycle" : "Collapse Call Cycle",
+                                   [this, id, collapsed]() {
+                        setComponentCollapsed(id, !collapsed);
+                    });
+                }
+            }
+            if (index != GraphGenerator::FrozenGraph::npos) {
+                menu.addAction("Highlight Paths From Entry", [this, id]() {
+                    highlightPaths(-1, id, MaxHighlightedPaths);
+                });
+                menu.addAction("Highlight Paths To Exit", [this, id]() {
+                    highlightPaths(id, -1, MaxHighlightedPaths);
+                });
+            }
+        }
         menu.addSeparator();
     }
     menu.addAction("Export Graph", this, &MainWindow::handleExport);
@@ -2430,13 +2916,8 @@ void MainWindow::onParseButtonClicked()
             // Parse DOT content
             auto graph = parseDotToCFG(dotContent);
             
-            // Count nodes and edges
-            int nodeCount = 0;
-            int edgeCount = 0;
-            for (const auto& [id, node] : graph->getNodes()) {
-                nodeCount++;
-                edgeCount += node.successors.size();
-            }
+            int nodeCount = static_cast<int>(graph->nodeCount());
+            int edgeCount = static_cast<int>(graph->edgeCount());
             
             QString report = QString("Parsed CFG from DOT file\n\n")
                            + QString("File: %1\n").arg(filePath)
@@ -2615,6 +3096,10 @@ void MainWindow::on_analyzeButton_clicked()
     QApplication::setOverrideCursor(Qt::WaitCursor);
     
     try {
+        // Headers may have changed outside the watched file; a user-started
+        // run re-reads everything once and then shares it across TUs.
+        CFGAnalyzer::SharedFileCache::instance().clear();
+
         // Clear previous results
         ui->reportTextEdit->clear();
         loadEmptyVisualization();
@@ -2622,47 +3107,23 @@ void MainWindow::on_analyzeButton_clicked()
         qDebug() << "Starting analysis of" << sourceFiles.size() << "files";
         statusBar()->showMessage("Analyzing files...");
         
-        CFGAnalyzer::CFGAnalyzer analyzer;
-        
-        auto result = analyzer.analyzeFiles(sourceFiles);
+        // Files that fail are listed in the report; only a batch where
+        // every file failed is an error.
+        CFGAnalyzer::AnalysisResult result;
+        {
+            QMutexLocker locker(&m_analyzerMutex);
+            result = m_analyzer.analyzeFiles(sourceFiles);
+        }
         if (!result.success) {
-            std::string combinedDot = "digraph G {\n";
-            std::string combinedReport = "Analysis Results:\n\n";
-            bool anySuccess = false;
-            
-            for (const auto& file : sourceFiles) {
-                auto singleResult = analyzer.analyzeFile(QString::fromStdString(file));
-                if (singleResult.success) {
-                    std::string filtered = filterDotOutput(singleResult.dotOutput);
-                    combinedDot += "subgraph \"" + file + "\" {\n";
-                    combinedDot += filtered;
-                    combinedDot += "}\n\n";
-                    
-                    combinedReport += "== File: " + file + " ==\n";
-                    combinedReport += singleResult.report + "\n\n";
-                    anySuccess = true;
-                } else {
-                    combinedReport += "== File: " + file + " (Analysis Failed) ==\n";
-                    combinedReport += singleResult.report + "\n\n";
-                }
-            }
-            combinedDot += "}\n";
-            
-            if (!anySuccess) {
-                throw std::runtime_error(combinedReport);
-            }
-            
-            // Create merged results
-            result.success = true;
-            result.dotOutput = combinedDot;
-            result.report = combinedReport;
+            throw std::runtime_error(result.report);
         }
         
         // Process results
-        if (!result.dotOutput.empty()) {
-            m_currentGraph = parseDotToCFG(QString::fromStdString(result.dotOutput));
-            visualizeCFG(m_currentGraph);
+        if (result.graph) {
+            m_currentGraph = std::move(result.graph);
+            visualizeCFG(m_currentGraph, GraphKind::CallGraph);
         }
+        m_metrics = std::move(result.metrics);
         
         ui->reportTextEdit->setPlainText(QString::fromStdString(result.report));
         statusBar()->showMessage("Analysis completed", 3000);
@@ -2680,30 +3141,6 @@ void MainWindow::on_analyzeButton_clicked()
     QApplication::restoreOverrideCursor();
 }
 
-std::string MainWindow::filterDotOutput(const std::string& dotContent) {
-    std::string filtered;
-    std::istringstream stream(dotContent);
-    std::string line;
-    bool inContent = false;
-    
-    while (std::getline(stream, line)) {
-        // Skip header and footer lines
-        if (line.find("digraph") != std::string::npos) {
-            inContent = true;
-            continue;
-        }
-        if (line == "}" && inContent) {
-            break;
-        }
-        
-        if (inContent && !line.empty()) {
-            filtered += line + "\n";
-        }
-    }
-    
-    return filtered;
-}
-
 void MainWindow::analyzeSingleFile(const QString& filePath) {
     if (filePath.isEmpty() || !QFile::exists(filePath)) {
         QMessageBox::warning(this, "Error", "Please select a valid file");
@@ -2714,6 +3151,7 @@ void MainWindow::analyzeSingleFile(const QString& filePath) {
     
     try {
         QFileInfo fileInfo(filePath);
+        CFGAnalyzer::SharedFileCache::instance().clear();
         
         ui->reportTextEdit->clear();
         loadEmptyVisualization(); 
@@ -2721,31 +3159,34 @@ void MainWindow::analyzeSingleFile(const QString& filePath) {
         qDebug() << "Starting analysis of file:" << filePath;
         statusBar()->showMessage("Analyzing file...");
         
-        CFGAnalyzer::CFGAnalyzer analyzer;
-        auto result = analyzer.analyzeFile(filePath);
+        // The member analyzer keeps this file's AST and preamble alive, so
+        // re-analyzing after an edit only re-parses the main-file body.
+        CFGAnalyzer::AnalysisResult result;
+        {
+            QMutexLocker locker(&m_analyzerMutex);
+            result = m_analyzer.analyzeFile(filePath);
+        }
         
         if (!result.success) {
             throw std::runtime_error(result.report);
         }
-        
-        qDebug() << "Analysis completed successfully, DOT output size:" 
-                << result.dotOutput.size() << "bytes";
-                
-        if (result.dotOutput.empty()) {
-            qWarning() << "Analysis produced empty DOT output";
-            throw std::runtime_error("Analysis completed but no graph was generated");
+
+        m_functionNames.clear();
+        for (const auto& [name, info] : result.functions) {
+            m_functionNames.insert(QString::fromStdString(name));
         }
+        m_metrics = std::move(result.metrics);
         
-        m_currentGraph = parseDotToCFG(QString::fromStdString(result.dotOutput));
-        if (!m_currentGraph || m_currentGraph->getNodes().empty()) {
-            qWarning() << "Failed to parse DOT to CFG or graph is empty";
-            throw std::runtime_error("Failed to create graph from analysis results");
+        m_currentGraph = std::move(result.graph);
+        if (!m_currentGraph || m_currentGraph->empty()) {
+            qWarning() << "Analysis produced an empty graph";
+            throw std::runtime_error("Analysis completed but no graph was generated");
         }
         
-        qDebug() << "Successfully parsed CFG with" << m_currentGraph->getNodes().size() << "nodes";
+        qDebug() << "Analysis completed successfully with" << m_currentGraph->nodeCount() << "nodes";
         
-        // Display the graph
-        displayGraph(QString::fromStdString(result.dotOutput));
+        // Display the graph, recursion cycles folded
+        visualizeCFG(m_currentGraph, GraphKind::CallGraph);
         
         ui->reportTextEdit->setPlainText(QString::fromStdString(result.report));
         statusBar()->showMessage("Analysis completed", 3000);
@@ -2758,6 +3199,108 @@ void MainWindow::analyzeSingleFile(const QString& filePath) {
     QApplication::restoreOverrideCursor();
 }
 
+void MainWindow::reanalyzeChangedFunctions(const QString& filePath)
+{
+    statusBar()->showMessage("Re-analyzing changed functions...");
+
+    // m_analyzer still holds the AST and function fingerprints from the last
+    // run, so only edited functions get a new CFG.
+    QtConcurrent::run(&m_analyzerJobs, [this, filePath]() {
+        QMutexLocker locker(&m_analyzerMutex);
+        QElapsedTimer timer;
+        timer.start();
+        auto result = std::make_shared<CFGAnalyzer::AnalysisResult>(
+            m_analyzer.analyzeFile(filePath));
+        qint64 elapsedMs = timer.elapsed();
+        locker.unlock();
+
+        QMetaObject::invokeMethod(this, [this, result, elapsedMs]() {
+            if (!result->success) {
+                statusBar()->showMessage("Re-analysis failed", 3000);
+                ui->reportTextEdit->setPlainText(QString::fromStdString(result->report));
+                return;
+            }
+
+            ui->reportTextEdit->setPlainText(QString::fromStdString(result->report));
+            m_metrics = std::move(result->metrics);
+
+            m_currentGraph = std::move(result->graph);
+            m_graphKind = GraphKind::CallGraph;
+            QString dotContent = m_currentGraph ? generateInteractiveDot(currentView()) : QString();
+            if (result->changedFunctions.empty() && dotContent == m_currentDotContent) {
+                statusBar()->showMessage(
+                    QString("No function changed (%1 ms)").arg(elapsedMs), 3000);
+                return;
+            }
+
+            displayGraph(dotContent);
+            statusBar()->showMessage(
+                QString("Rebuilt %1 function CFG(s) in %2 ms")
+                    .arg(result->changedFunctions.size()).arg(elapsedMs), 3000);
+        });
+    });
+};
+
+void MainWindow::refreshFunctionUnderCursor()
+{
+    if (m_currentFile.isEmpty()) return;
+    if (m_liveRefreshRunning) {
+        m_liveRefreshPending = true;
+        return;
+    }
+
+    QString filePath = m_currentFile;
+    unsigned cursorLine = static_cast<unsigned>(ui->codeEditor->textCursor().blockNumber() + 1);
+    {
+        // Set here, not in the job, so it stays ordered with the
+        // clearUnsavedBuffer() a later load or save does on this thread.
+        QMutexLocker locker(&m_analyzerMutex);
+        m_analyzer.setUnsavedBuffer(filePath.toStdString(), ui->codeEditor->toPlainText().toStdString());
+    }
+    m_liveRefreshRunning = true;
+
+    QtConcurrent::run(&m_analyzerJobs, [this, filePath, cursorLine]() {
+        QMutexLocker locker(&m_analyzerMutex);
+        std::string filename = filePath.toStdString();
+        std::string functionName;
+        auto result = std::make_shared<CFGAnalyzer::AnalysisResult>(m_analyzer.analyzeFile(filePath));
+        if (result->success) {
+            // Nested lambdas and local classes share the cursor line with
+            // their enclosing function; the innermost has the latest start,
+            // then the earliest end.
+            const CFGAnalyzer::FunctionInfo* innermost = nullptr;
+            for (const auto& [name, info] : result->functions) {
+                if (info.line > cursorLine || cursorLine > info.endLine) continue;
+                if (!innermost || info.line > innermost->line ||
+                    (info.line == innermost->line && info.endLine < innermost->endLine)) {
+                    innermost = &info;
+                    functionName = name;
+                }
+            }
+            if (!functionName.empty()) {
+                *result = m_analyzer.analyzeFunction(filename, functionName);
+            }
+        }
+        locker.unlock();
+
+        QMetaObject::invokeMethod(this, [this, result, functionName]() {
+            m_liveRefreshRunning = false;
+            if (result->success && !functionName.empty()) {
+                // An unchanged function comes back as the very graph on screen
+                if (result->graph != m_currentGraph) {
+                    visualizeCFG(std::move(result->graph));
+                }
+                statusBar()->showMessage(
+                    QString("Live CFG: %1").arg(QString::fromStdString(functionName)), 2000);
+            }
+            if (m_liveRefreshPending) {
+                m_liveRefreshPending = false;
+                m_liveRefreshTimer->start();
+            }
+        });
+    });
+};
+
 void MainWindow::displayFunctionInfo(const QString& input)
 {
     if (!m_currentGraph) {
@@ -2765,31 +3308,32 @@ void MainWindow::displayFunctionInfo(const QString& input)
         return;
     }
     
-    const auto& nodes = m_currentGraph->getNodes();
+    const auto& graph = *m_currentGraph;
     bool found = false;
     
-    for (const auto& [id, node] : nodes) {
-        if (node.functionName.contains(input, Qt::CaseInsensitive)) {
+    for (uint32_t i = 0; i < graph.nodeCount(); ++i) {
+        if (graph.functionName(i).contains(input, Qt::CaseInsensitive)) {
             found = true;
-            ui->reportTextEdit->append(QString("Function: %1").arg(node.functionName));
-            ui->reportTextEdit->append(QString("Node ID: %1").arg(id));
-            ui->reportTextEdit->append(QString("Label: %1").arg(node.label));
+            ui->reportTextEdit->append(QString("Function: %1").arg(graph.functionName(i)));
+            ui->reportTextEdit->append(QString("Node ID: %1").arg(graph.id(i)));
+            ui->reportTextEdit->append(QString("Label: %1").arg(graph.label(i)));
             
-            if (!node.statements.empty()) {
+            if (!graph.statements(i).empty()) {
                 ui->reportTextEdit->append("\nStatements:");
-                for (const QString& stmt : node.statements) {
-                    ui->reportTextEdit->append(stmt);
+                for (const GraphGenerator::StatementText& stmt : graph.statements(i)) {
+                    ui->reportTextEdit->append(stmt.toQString());
                 }
             }
             
-            if (!node.successors.empty()) {
+            if (!graph.successors(i).empty()) {
                 ui->reportTextEdit->append("\nConnects to:");
-                for (int successor : node.successors) {
-                    QString edgeType = m_currentGraph->isExceptionEdge(id, successor) 
+                uint32_t edge = graph.firstEdge(i);
+                for (uint32_t successor : graph.successors(i)) {
+                    QString edgeType = graph.edgeFlags(edge++) & GraphGenerator::ExceptionEdge
                         ? " (exception edge)" 
                         : "";
                     ui->reportTextEdit->append(QString("  -> Node %1%2")
-                                              .arg(successor)
+                                              .arg(graph.id(successor))
                                               .arg(edgeType));
                 }
             }
@@ -2888,7 +3432,7 @@ void MainWindow::visualizeFunction(const QString& functionName)
     setUiEnabled(false);
     statusBar()->showMessage("Generating CFG for function...");
     
-    QtConcurrent::run([this, filePath, functionName]() {
+    QtConcurrent::run(&m_analyzerJobs, [this, filePath, functionName]() {
         try {
             auto cfgGraph = generateFunctionCFG(filePath, functionName);
             QMetaObject::invokeMethod(this, [this, cfgGraph]() {
@@ -2902,12 +3446,15 @@ void MainWindow::visualizeFunction(const QString& functionName)
     });
 };
 
-std::shared_ptr<GraphGenerator::CFGGraph> MainWindow::generateFunctionCFG(
+std::shared_ptr<const GraphGenerator::FrozenGraph> MainWindow::generateFunctionCFG(
     const QString& filePath, const QString& functionName)
 {
     try {
-        CFGAnalyzer::CFGAnalyzer analyzer;
-        auto result = analyzer.analyzeFile(filePath);
+        QMutexLocker locker(&m_analyzerMutex);
+        auto result = functionName.isEmpty()
+            ? m_analyzer.analyzeFile(filePath)
+            : m_analyzer.analyzeFunction(filePath.toStdString(), functionName.toStdString());
+        locker.unlock();
         if (!result.success) {
             QString detailedError = QString("Failed to analyze file %1:\n%2")
                                   .arg(filePath)
@@ -2915,23 +3462,8 @@ std::shared_ptr<GraphGenerator::CFGGraph> MainWindow::generateFunctionCFG(
             throw std::runtime_error(detailedError.toStdString());
         }
         
-        auto cfgGraph = std::make_shared<GraphGenerator::CFGGraph>();
-        if (!result.dotOutput.empty()) {
-            cfgGraph = parseDotToCFG(QString::fromStdString(result.dotOutput));
-            if (!functionName.isEmpty()) {
-                auto filteredGraph = std::make_shared<GraphGenerator::CFGGraph>();
-                const auto& nodes = cfgGraph->getNodes();
-                for (const auto& [id, node] : nodes) {
-                    if (node.functionName.compare(functionName, Qt::CaseInsensitive) == 0) {
-                        filteredGraph->addNode(id);
-                        for (int successor : node.successors) {
-                            filteredGraph->addEdge(id, successor);
-                        }
-                    }
-                }
-                cfgGraph = filteredGraph;
-            }
-        }
+        auto cfgGraph = result.graph ? std::move(result.graph)
+                                     : GraphGenerator::CFGGraph().freeze();
         return cfgGraph;
     } catch (const std::exception& e) {
         qCritical() << "Error generating function CFG:" << e.what();
@@ -2945,7 +3477,7 @@ void MainWindow::connectSignals() {
         if (!filePath.isEmpty()) {
             std::vector<std::string> sourceFiles = { filePath.toStdString() };
             auto graph = GraphGenerator::generateCFG(sourceFiles);
-            m_currentGraph = std::shared_ptr<GraphGenerator::CFGGraph>(graph.release());
+            m_currentGraph = graph->freeze();
             visualizeCurrentGraph();
         }
     });
@@ -3009,8 +3541,15 @@ void MainWindow::loadFile(const QString& filePath)
     QString content = in.readAll();
     file.close();
     
+    // The disk copy is authoritative again
+    {
+        QMutexLocker locker(&m_analyzerMutex);
+        m_analyzer.clearUnsavedBuffer(filePath.toStdString());
+    }
+
     // Update UI
     ui->codeEditor->setPlainText(content);
+    ui->codeEditor->document()->setModified(false);
     ui->filePathEdit->setText(filePath);
     m_currentFile = filePath;
     
@@ -3044,12 +3583,17 @@ void MainWindow::openFile(const QString& filePath)
 
 void MainWindow::fileChanged(const QString& path)
 {
+    CFGAnalyzer::SharedFileCache::instance().invalidate(path.toStdString());
+
     if (QFileInfo::exists(path)) {
         int ret = QMessageBox::question(this, "File Changed",
                                       "The file has been modified externally. Reload?",
                                       QMessageBox::Yes | QMessageBox::No);
         if (ret == QMessageBox::Yes) {
             loadFile(path);
+            if (path == m_currentFile && m_currentGraph) {
+                reanalyzeChangedFunctions(path);
+            }
         }
     } else {
         QMessageBox::warning(this, "File Removed", 
@@ -3131,7 +3675,7 @@ void MainWindow::highlightInCodeEditor(int nodeId) {
     }
 };
 
-void MainWindow::handleVisualizationResult(std::shared_ptr<GraphGenerator::CFGGraph> graph) {
+void MainWindow::handleVisualizationResult(std::shared_ptr<const GraphGenerator::FrozenGraph> graph) {
     if (graph) {
         m_currentGraph = graph;
         visualizeCFG(graph);
@@ -3306,12 +3850,20 @@ void MainWindow::onNodeClicked(const QString& nodeId) {
         return;
     }
 
-    const auto& nodes = m_currentGraph->getNodes();
-    auto it = nodes.find(id);
-    if (it != nodes.end()) {
-        displayNodeDetails(id, it->second);
+    if (m_currentGraph->contains(id)) {
+        displayNodeDetails(id);
         highlightNodeInCodeEditor(id);
     }
+
+    // Clicking a folded region or recursion cycle opens it
+    if (m_regionView.graph() == m_currentGraph && setRegionCollapsed(id, false)) {
+        statusBar()->showMessage(QString("Expanded region at node %1").arg(id), 3000);
+        return;
+    }
+    if (setComponentCollapsed(id, false)) {
+        statusBar()->showMessage(QString("Expanded call cycle at node %1").arg(id), 3000);
+        return;
+    }
     
     statusBar()->showMessage(QString("Node %1 selected").arg(id), 3000);
 };
@@ -3331,15 +3883,15 @@ void MainWindow::highlightNodeInCodeEditor(int nodeId) {
         return;
     }
     
-    const auto& nodes = m_currentGraph->getNodes();
-    auto it = nodes.find(nodeId);
-    if (it == nodes.end()) {
+    uint32_t index = m_currentGraph->indexOf(nodeId);
+    if (index == GraphGenerator::FrozenGraph::npos) {
         qDebug() << "Node" << nodeId << "not found in graph";
         return;
     }
     
-    const auto& node = it->second;
-    auto [filename, startLine, endLine] = node.getSourceRange();
+    QString filename = m_currentGraph->filename(index);
+    int startLine = m_currentGraph->startLine(index);
+    int endLine = m_currentGraph->endLine(index);
     
     qDebug() << "Node info - File:" << filename 
              << "Lines:" << startLine << "-" << endLine;
@@ -3458,12 +4010,16 @@ void MainWindow::highlightNodeInCodeEditor(int nodeId) {
     QApplication::processEvents();
 };
 
-void MainWindow::displayNodeDetails(int nodeId, const GraphGenerator::CFGNode& node) {
+void MainWindow::displayNodeDetails(int nodeId) {
+    const auto& graph = *m_currentGraph;
+    uint32_t index = graph.indexOf(nodeId);
+    if (index == GraphGenerator::FrozenGraph::npos) return;
+
     QString report;
     
     // Basic node information
     report += QString("=== Node %1 ===\n").arg(nodeId);
-    report += QString("Label: %1\n").arg(node.label);
+    report += QString("Label: %1\n").arg(graph.label(index));
     
     // Source location information
     if (m_nodeInfoMap.contains(nodeId)) {
@@ -3473,28 +4029,34 @@ void MainWindow::displayNodeDetails(int nodeId, const GraphGenerator::CFGNode& n
     }
     
     // Node type information
-    if (m_currentGraph->isNodeTryBlock(nodeId)) {
+    if (graph.nodeFlags(index) & GraphGenerator::TryBlock) {
         report += "Type: Try Block\n";
     }
-    if (m_currentGraph->isNodeThrowingException(nodeId)) {
+    if (graph.nodeFlags(index) & GraphGenerator::ThrowsException) {
         report += "Type: Exception Throw\n";
     }
+    if (m_callGraphView.graph() == m_currentGraph) {
+        uint32_t component = graph.components().componentOf(index);
+        report += QString("SCC: %1%2\n").arg(component)
+            .arg(graph.components().isCyclic(component) ? " (recursive)" : "");
+    }
     
     // Connections
     report += "\nConnections:\n";
     report += "  Successors: ";
-    for (int succ : node.successors) {
-        QString edgeType = m_currentGraph->isExceptionEdge(nodeId, succ) ? 
+    uint32_t edge = graph.firstEdge(index);
+    for (uint32_t succ : graph.successors(index)) {
+        QString edgeType = graph.edgeFlags(edge++) & GraphGenerator::ExceptionEdge ? 
             "(exception)" : "(normal)";
-        report += QString("%1 %2, ").arg(succ).arg(edgeType);
+        report += QString("%1 %2, ").arg(graph.id(succ)).arg(edgeType);
     }
     report += "\n";
     
     // Code content
-    if (!node.statements.empty()) {
+    if (!graph.statements(index).empty()) {
         report += "\nCode Content:\n";
-        for (const QString& stmt : node.statements) {
-            report += "  " + stmt + "\n";
+        for (const GraphGenerator::StatementText& stmt : graph.statements(index)) {
+            report += "  " + stmt.toQString() + "\n";
         }
     }
     
@@ -3528,6 +4090,149 @@ void MainWindow::onAddFileClicked()
     }
 }
 
+void MainWindow::onAnalyzeProjectClicked()
+{
+    QString databasePath = QFileDialog::getOpenFileName(
+        this,
+        "Select Compilation Database",
+        QDir::homePath(),
+        "Compilation Database (compile_commands.json);;JSON Files (*.json)"
+    );
+    if (databasePath.isEmpty()) return;
+
+    bool ok = false;
+    int jobs = QInputDialog::getInt(this, "Analyze Project", "Worker threads (-j):",
+                                    static_cast<int>(CFGAnalyzer::WorkerPool::defaultJobs()),
+                                    1, 256, 1, &ok);
+    if (!ok) return;
+
+    setUiEnabled(false);
+    ui->reportTextEdit->clear();
+    statusBar()->showMessage("Analyzing project...");
+    CFGAnalyzer::SharedFileCache::instance().clear();
+
+    if (m_outOfProcessAction->isChecked()) {
+        delete m_bridge;
+        CFGBridge::Options bridgeOptions;
+        bridgeOptions.workers = jobs;
+        m_bridge = new CFGBridge(bridgeOptions, this);
+        connect(m_bridge, &CFGBridge::progress, this, [this](int completed, int total) {
+            statusBar()->showMessage(QString("Analyzing project... %1/%2").arg(completed).arg(total));
+        });
+        connect(m_bridge, &CFGBridge::errorOccurred, this, [](const QString& message) {
+            qWarning() << "Out-of-process analysis:" << message;
+        });
+        connect(m_bridge, &CFGBridge::analysisComplete, this,
+                [this](const CFGAnalyzer::AnalysisResult&) {
+            onAnalysisComplete(m_bridge->takeResult());
+            statusBar()->showMessage("Project analysis completed", 3000);
+        });
+        m_bridge->analyzeProject(databasePath);
+        return;
+    }
+
+    CFGAnalyzer::AnalysisOptions options;
+    {
+        QMutexLocker locker(&m_analyzerMutex);
+        options = m_analyzer.options();
+    }
+    QtConcurrent::run([this, databasePath, jobs, options]() mutable {
+        CFGAnalyzer::CFGAnalyzer analyzer;
+        options.jobs = static_cast<unsigned>(jobs);
+        analyzer.setOptions(options);
+
+        auto result = std::make_shared<CFGAnalyzer::AnalysisResult>(
+            analyzer.analyzeProject(databasePath.toStdString()));
+        QMetaObject::invokeMethod(this, [this, result]() {
+            onAnalysisComplete(std::move(*result));
+            statusBar()->showMessage("Project analysis completed", 3000);
+        });
+    });
+}
+
+void MainWindow::showFunctionMetrics()
+{
+    if (m_metrics.empty()) {
+        QMessageBox::information(this, "Function Metrics", "Analyze a file or project first.");
+        return;
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle(QString("Function Metrics (%1 functions)").arg(m_metrics.size()));
+    dialog.resize(900, 600);
+
+    QComboBox* sortBox = new QComboBox(&dialog);
+    QComboBox* filterBox = new QComboBox(&dialog);
+    for (size_t m = 0; m < CFGAnalyzer::MetricCount; ++m) {
+        QString name = CFGAnalyzer::metricName(static_cast<CFGAnalyzer::Metric>(m));
+        sortBox->addItem(name);
+        filterBox->addItem(name);
+    }
+    QSpinBox* minimumBox = new QSpinBox(&dialog);
+    minimumBox->setRange(0, std::numeric_limits<int>::max());
+    minimumBox->setPrefix(">= ");
+
+    QTableWidget* table = new QTableWidget(&dialog);
+    QStringList headers{"Function"};
+    for (int m = 0; m < sortBox->count(); ++m) {
+        headers << sortBox->itemText(m);
+    }
+    table->setColumnCount(headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->verticalHeader()->hide();
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    // Rows come from the table already filtered and sorted; nothing is
+    // measured again.
+    QLabel* countLabel = new QLabel(&dialog);
+    auto refill = [this, table, sortBox, filterBox, minimumBox, countLabel]() {
+        auto sortBy = static_cast<CFGAnalyzer::Metric>(sortBox->currentIndex());
+        auto filterBy = static_cast<CFGAnalyzer::Metric>(filterBox->currentIndex());
+        std::vector<uint32_t> rows = m_metrics.select(
+            sortBy, true, {{filterBy, static_cast<uint32_t>(minimumBox->value())}});
+
+        table->setUpdatesEnabled(false);
+        table->clearContents();
+        table->setRowCount(static_cast<int>(rows.size()));
+        for (int i = 0; i < static_cast<int>(rows.size()); ++i) {
+            table->setItem(i, 0, new QTableWidgetItem(QString::fromStdString(m_metrics.name(rows[i]))));
+            for (size_t m = 0; m < CFGAnalyzer::MetricCount; ++m) {
+                auto* item = new QTableWidgetItem();
+                item->setData(Qt::DisplayRole, m_metrics.value(rows[i], static_cast<CFGAnalyzer::Metric>(m)));
+                table->setItem(i, static_cast<int>(m) + 1, item);
+            }
+        }
+        table->setUpdatesEnabled(true);
+        countLabel->setText(QString("%1 of %2 functions").arg(rows.size()).arg(m_metrics.size()));
+    };
+    connect(sortBox, QOverload<int>::of(&QComboBox::currentIndexChanged), &dialog, refill);
+    connect(filterBox, QOverload<int>::of(&QComboBox::currentIndexChanged), &dialog, refill);
+    connect(minimumBox, QOverload<int>::of(&QSpinBox::valueChanged), &dialog, refill);
+    connect(table->horizontalHeader(), &QHeaderView::sectionClicked, &dialog, [sortBox](int section) {
+        if (section > 0) {
+            sortBox->setCurrentIndex(section - 1);
+        }
+    });
+
+    QHBoxLayout* controls = new QHBoxLayout();
+    controls->addWidget(new QLabel("Sort by:"));
+    controls->addWidget(sortBox);
+    controls->addWidget(new QLabel("Filter:"));
+    controls->addWidget(filterBox);
+    controls->addWidget(minimumBox);
+    controls->addStretch();
+    controls->addWidget(countLabel);
+
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+    layout->addLayout(controls);
+    layout->addWidget(table);
+
+    refill();
+    dialog.exec();
+}
+
 void MainWindow::onRemoveFileClicked()
 {
     QListWidget* fileListWidget = ui->centralwidget->findChild<QListWidget*>("fileListWidget");
@@ -3610,6 +4315,7 @@ void MainWindow::displayGraph(const QString& dotContent, bool isProgressive, int
         .node:hover { stroke-width:2px; cursor:pointer; }
         .error-message { color:red; padding:20px; text-align:center; }
         .loading { text-align:center; padding-top:50px; color:#666; }
+%2
     </style>
 </head>
 <body>
@@ -3620,6 +4326,7 @@ void MainWindow::displayGraph(const QString& dotContent, bool isProgressive, int
         // For debugging
         console.log("HTML template loaded with DOT content length: " + `%1`.length);
         
+%3
         // Setup QWebChannel first before any other code
         var bridge = null;
         try {
@@ -3685,7 +4392,7 @@ void MainWindow::displayGraph(const QString& dotContent, bool isProgressive, int
     </script>
 </body>
 </html>
-    )").arg(escapedDot);
+    )").arg(escapedDot, GraphHighlightStyle, GraphHighlightScript);
     
     // Load the HTML content
     webView->setHtml(html);
@@ -3760,7 +4467,7 @@ void MainWindow::loadEmptyVisualization() {
     m_currentDotContent.clear();
     m_pendingDotContent.clear();
     m_expandedNodes.clear();
-    m_visibleNodes.clear();
+    m_visibleNodes.reset(nullptr);
 }
 
 void MainWindow::onSearchButtonClicked() {
@@ -3908,6 +4615,9 @@ QString MainWindow::getNodeAtPosition(const QPoint& pos) const {
 }
 
 MainWindow::~MainWindow() {
+    // Queued jobs are dropped; a running one still uses m_analyzer and this.
+    m_analyzerJobs.clear();
+    m_analyzerJobs.waitForDone();
     if (m_analysisThread && m_analysisThread->isRunning()) {
         m_analysisThread->quit();
         m_analysisThread->wait();
@@ -1,11 +1,18 @@
 #include "mainwindow.h"
+#include "CFGBridge.h"
 #include <QApplication>
 #include <iostream>
 #include <QApplication>
 #include <QSurfaceFormat>
+#include <cstring>
 
 int main(int argc, char *argv[])
 {
+    // Out-of-process analysis workers never touch the GUI
+    if (argc > 1 && std::strcmp(argv[1], "--analysis-worker") == 0) {
+        return CFGBridge::runWorker();
+    }
+
     QApplication app(argc, argv);
     
     try {
@@ -1,27 +1,23 @@
 #include "parser.h"
+#include "graph_generator.h"
+#include "ast_session.h"
+#include "shared_file_cache.h"
 #include <clang/AST/RecursiveASTVisitor.h>
-#include <clang/Analysis/CFG.h>
 #include <clang/AST/Stmt.h>
 #include <clang/AST/ASTConsumer.h>
-#include <clang/AST/PrettyPrinter.h>
 #include <clang/Tooling/Tooling.h>
-#include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/FileSystem.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/CompilerInvocation.h>
 #include <clang/Frontend/FrontendActions.h>
-#include <regex>
 #include <filesystem>
 #include <sstream>
 #include <fstream>
-#include <unordered_map>
 #include <QDebug>
 
 using namespace clang;
 namespace fs = std::filesystem;
 
-static std::unordered_map<std::string, std::string> stmtCache;
-
 class Parser::FunctionVisitor : public RecursiveASTVisitor<FunctionVisitor> {
 public:
     explicit FunctionVisitor(ASTContext* context) : context(context) {}
@@ -120,90 +116,20 @@ std::vector<Parser::FunctionCFG> Parser::extractAllCFGs(const std::string& fileP
                 continue;
             }
             
-            FunctionCFG cfg;
-            cfg.functionName = funcInfo.name;
-            
-            std::unique_ptr<CFG> cfgPtr = CFG::buildCFG(
-                decl, 
-                decl->getBody(), 
-                context, 
-                CFG::BuildOptions()
-            );
-            
-            if (!cfgPtr) {
+            // Statements become slices of the source the pool keeps, so the
+            // graph outlives this parse.
+            auto graph = GraphGenerator::generateCFG(decl, m_strings);
+            if (!graph) {
                 qWarning() << "Failed to build CFG for function:" << funcInfo.name.c_str();
                 continue;
             }
-            
-            qDebug() << "Building CFG for function:" << funcInfo.name.c_str() << "with" << cfgPtr->size() << "blocks";
-            
-            // Process nodes
-            for (const CFGBlock* block : *cfgPtr) {
-                CFGNode node;
-                node.id = block->getBlockID();
-                
-                std::string label;
-                if (block->empty()) {
-                    label = (node.id == 0) ? "ENTRY" : "EXIT";
-                } else {
-                    for (const auto& element : *block) {
-                        if (element.getKind() == CFGElement::Statement) {
-                            const Stmt* stmt = element.castAs<CFGStmt>().getStmt();
-                            std::string stmtStr;
-                            llvm::raw_string_ostream os(stmtStr);
-                            stmt->printPretty(os, nullptr, PrintingPolicy(context->getLangOpts()));
-                            os.flush();
-                            
-                            if (stmtCache.count(stmtStr)) {
-                                label += stmtCache[stmtStr];
-                            } else {
-                                stmtCache[stmtStr] = stmtStr + "\n";
-                                label += stmtCache[stmtStr];
-                            }
-                            
-                            if (node.code.empty()) node.code = stmtStr;
-                        }
-                    }
-                }
-                
-                node.label = label.empty() ? "Empty Block" : label;
-                SourceLocation loc = block->empty() ? SourceLocation() :
-                    (block->front().getKind() == CFGElement::Statement) ?
-                        block->front().castAs<CFGStmt>().getStmt()->getBeginLoc() :
-                        SourceLocation();
-                auto presumedLoc = context->getSourceManager().getPresumedLoc(loc);
-                node.line = presumedLoc.isValid() ? presumedLoc.getLine() : 0;
-                
-                cfg.nodes.push_back(node);
-            }
-            
-            for (const CFGBlock* block : *cfgPtr) {
-                unsigned sourceId = block->getBlockID();
-                unsigned edgeIdx = 0;
-                
-                for (auto it = block->succ_begin(); it != block->succ_end(); ++it) {
-                    if (const CFGBlock* succ = *it) {
-                        CFGEdge edge;
-                        edge.sourceId = sourceId;
-                        edge.targetId = succ->getBlockID();
-                        
-                        if (block->succ_size() > 1) {
-                            edge.label = (edgeIdx == 0) ? "True" : "False";
-                        } else {
-                            edge.label = "Unconditional";
-                        }
-                        
-                        cfg.edges.push_back(edge);
-                        edgeIdx++;
-                    } else {
-                        qWarning() << "Null successor found for block ID:" << sourceId << "in function:" << funcInfo.name.c_str();
-                    }
-                }
-            }
-            
-            cfgs.push_back(cfg);
+
+            FunctionCFG cfg;
+            cfg.functionName = funcInfo.name;
+            cfg.graph = graph->freeze();
             qDebug() << "Successfully built CFG for" << funcInfo.name.c_str() 
-                    << "with" << cfg.nodes.size() << "nodes and" << cfg.edges.size() << "edges";
+                    << "with" << cfg.graph->nodeCount() << "nodes and" << cfg.graph->edgeCount() << "edges";
+            cfgs.push_back(std::move(cfg));
         }
     } catch (const std::exception& e) {
         qCritical() << "Exception while extracting CFGs from" << filePath.c_str() 
@@ -222,43 +148,51 @@ std::string Parser::generateDOT(const FunctionCFG& cfg) {
         dot << "  node [shape=rectangle, fontname=\"Courier\", fontsize=10];\n";
         dot << "  edge [fontsize=8];\n\n";
         
+        const GraphGenerator::FrozenGraph& graph = *cfg.graph;
+
         // Add nodes
-        for (const auto& node : cfg.nodes) {
-            dot << "  " << node.id << " [";
+        for (uint32_t i = 0; i < graph.nodeCount(); ++i) {
+            dot << "  " << graph.id(i) << " [";
             
-            if (node.id == 0) {
+            if (graph.label(i) == "ENTRY") {
                 dot << "label=\"ENTRY\", shape=diamond, style=filled, fillcolor=palegreen";
-            } else if (node.id == 1 && cfg.nodes.size() > 1) {
+            } else if (graph.label(i) == "EXIT") {
                 dot << "label=\"EXIT\", shape=diamond, style=filled, fillcolor=palegreen";
+            } else if (graph.statements(i).empty()) {
+                dot << "label=\"Empty Block\"";
             } else {
-                std::string label = node.label;
-                std::replace(label.begin(), label.end(), '"', '\'');
-                label = std::regex_replace(label, std::regex("\n"), "\\n");
-                
-                dot << "label=\"" << label << "\"";
-                
-                if (node.label.find('\n') != std::string::npos) {
-                    dot << ", style=filled, fillcolor=lemonchiffon";
+                dot << "label=\"";
+                for (const GraphGenerator::StatementText& stmt : graph.statements(i)) {
+                    for (char c : stmt.str()) {
+                        if (c == '"') dot << '\'';
+                        else if (c == '\n') dot << "\\n";
+                        else dot << c;
+                    }
+                    dot << "\\n";
                 }
+                dot << "\", style=filled, fillcolor=lemonchiffon";
             }
             
             dot << "];\n";
         }
         
         // Add edges
-        for (const auto& edge : cfg.edges) {
-            dot << "  " << edge.sourceId << " -> " << edge.targetId;
-            
-            if (!edge.label.empty()) {
-                dot << " [label=\"" << edge.label << "\"";
+        for (uint32_t i = 0; i < graph.nodeCount(); ++i) {
+            uint32_t edge = graph.firstEdge(i);
+            for (uint32_t successor : graph.successors(i)) {
+                GraphGenerator::EdgeFlags flags = graph.edgeFlags(edge++);
+                dot << "  " << graph.id(i) << " -> " << graph.id(successor);
                 
-                if (edge.label == "True" || edge.label == "False") {
-                    dot << ", color=blue";
+                if (flags & GraphGenerator::TrueBranch) {
+                    dot << " [label=\"True\", color=blue";
+                } else if (flags & GraphGenerator::FalseBranch) {
+                    dot << " [label=\"False\", color=blue";
+                } else {
+                    dot << " [label=\"Unconditional\"";
                 }
                 
+                dot << "];\n";
             }
-            
-            dot << "];\n";
         }
 
         dot << "}\n";
@@ -277,33 +211,8 @@ std::unique_ptr<clang::ASTUnit> Parser::parseFileWithAST(const std::string& file
         return nullptr;
     }
 
-    std::string resourceDir;
-    if (llvm::sys::fs::exists("/usr/lib/llvm-14/lib/clang/14.0.0/include")) {
-        resourceDir = "/usr/lib/llvm-14/lib/clang/14.0.0/include";
-    } else {
-        bool found = false;
-        try {
-            if (fs::exists("/usr/lib/llvm")) {
-                for (const auto& entry : fs::directory_iterator("/usr/lib/llvm")) {
-                    if (entry.path().string().find("clang") != std::string::npos) {
-                        resourceDir = entry.path().string() + "/include";
-                        found = true;
-                        qDebug() << "Found clang resource dir:" << resourceDir.c_str();
-                        break;
-                    }
-                }
-            }
-            
-            if (!found) {
-                qWarning() << "Could not find clang resource directory. Using default paths.";
-            }
-        } catch (const fs::filesystem_error& e) {
-            qCritical() << "Filesystem error while searching for clang resources:" << e.what() 
-                       << "code:" << e.code().value() << e.code().message().c_str();
-        }
-    }
-
     std::vector<std::string> args = {
+        "-x", "c++",
         "-std=c++17",
         "-I.",
         "-ferror-limit=2",
@@ -312,13 +221,9 @@ std::unique_ptr<clang::ASTUnit> Parser::parseFileWithAST(const std::string& file
         "-Wno-everything"
     };
     
-    if (!resourceDir.empty()) {
-        args.push_back("-resource-dir=" + resourceDir);
-    }
-    
     qDebug() << "Parsing file with AST:" << filename.c_str() << "with" << args.size() << "args";
 
-    auto ast = clang::tooling::buildASTFromCodeWithArgs("", args, filename);
+    auto ast = CFGAnalyzer::ASTSession::loadUnit(filename, args);
     
     if (!ast) {
         qCritical() << "AST generation failed completely for:" << filename.c_str();
@@ -411,7 +316,7 @@ clang::ASTContext* Parser::ThreadLocalState::parse(const std::string& filePath)
 void Parser::ThreadLocalState::setupCompiler() {
     try {
         compiler->createDiagnostics();
-        compiler->createFileManager();
+        compiler->createFileManager(CFGAnalyzer::SharedFileCache::instance().createFileSystem());
         compiler->createSourceManager(compiler->getFileManager());
         compiler->createPreprocessor(TU_Complete);
         compiler->createASTContext();
@@ -423,7 +328,7 @@ void Parser::ThreadLocalState::setupCompiler() {
     }
 }
 
-Parser::Parser() {
+Parser::Parser() : m_strings(std::make_shared<GraphGenerator::StringPool>()) {
     qDebug() << "Parser instance created";
 }
 
@@ -0,0 +1,259 @@
+#include "shared_file_cache.h"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <unordered_set>
+
+namespace CFGAnalyzer {
+
+namespace {
+
+// Absolute path as a cache key. Only "." is folded: "a/link/../b" is not
+// "a/b" when link is a symlink, and the key must name the file that was
+// actually stat'ed or read.
+std::string cacheKey(llvm::SmallString<256>& absolute) {
+    llvm::sys::path::remove_dots(absolute, /*remove_dot_dot=*/false);
+    return std::string(absolute.str());
+}
+
+// Hands out cached contents without copying. The buffer keeps its cache
+// entry alive, so invalidating a path never pulls memory out from under a
+// SourceManager that is still using it.
+class SharedBuffer : public llvm::MemoryBuffer {
+public:
+    SharedBuffer(std::shared_ptr<llvm::MemoryBuffer> contents, const std::string& name,
+                 bool requiresNullTerminator)
+        : m_contents(std::move(contents)), m_name(name)
+    {
+        init(m_contents->getBufferStart(), m_contents->getBufferEnd(), requiresNullTerminator);
+    }
+
+    llvm::StringRef getBufferIdentifier() const override { return m_name; }
+    BufferKind getBufferKind() const override { return MemoryBuffer_Malloc; }
+
+private:
+    std::shared_ptr<llvm::MemoryBuffer> m_contents;
+    std::string m_name;
+};
+
+class CachedFile : public llvm::vfs::File {
+public:
+    CachedFile(llvm::vfs::Status status, std::shared_ptr<llvm::MemoryBuffer> contents)
+        : m_status(std::move(status)), m_contents(std::move(contents)) {}
+
+    llvm::ErrorOr<llvm::vfs::Status> status() override { return m_status; }
+
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> getBuffer(
+        const llvm::Twine& name, int64_t, bool requiresNullTerminator, bool) override
+    {
+        return std::unique_ptr<llvm::MemoryBuffer>(
+            new SharedBuffer(m_contents, name.str(), requiresNullTerminator));
+    }
+
+    std::error_code close() override { return std::error_code(); }
+
+private:
+    llvm::vfs::Status m_status;
+    std::shared_ptr<llvm::MemoryBuffer> m_contents;
+};
+
+} // namespace
+
+class CachingFileSystem : public llvm::vfs::ProxyFileSystem {
+public:
+    CachingFileSystem(llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> underlying,
+                      SharedFileCache& cache)
+        : ProxyFileSystem(std::move(underlying)), m_cache(cache) {}
+
+    llvm::ErrorOr<llvm::vfs::Status> status(const llvm::Twine& path) override {
+        std::string key = absolutePath(path);
+        llvm::ErrorOr<llvm::vfs::Status> cached =
+            std::make_error_code(std::errc::no_such_file_or_directory);
+        if (!m_cache.findStatus(key, cached)) {
+            cached = ProxyFileSystem::status(path);
+            m_cache.storeStatus(key, cached);
+        }
+        if (!cached) {
+            return cached.getError();
+        }
+        return llvm::vfs::Status::copyWithNewName(*cached, path.str());
+    }
+
+    llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> openFileForRead(const llvm::Twine& path) override {
+        std::string key = absolutePath(path);
+        auto contents = m_cache.findContents(key);
+        if (!contents) {
+            auto file = ProxyFileSystem::openFileForRead(path);
+            if (!file) {
+                return file.getError();
+            }
+            auto fileStatus = (*file)->status();
+            if (!fileStatus || !fileStatus->isRegularFile()) {
+                return file;
+            }
+            // Volatile forces a heap copy: a long-lived mmap of a file that is
+            // later truncated on disk would fault.
+            auto buffer = (*file)->getBuffer(path, fileStatus->getSize(),
+                                             /*RequiresNullTerminator=*/true,
+                                             /*IsVolatile=*/true);
+            if (!buffer) {
+                return buffer.getError();
+            }
+            contents = m_cache.storeContents(key, *fileStatus, std::move(*buffer));
+        }
+
+        return std::unique_ptr<llvm::vfs::File>(new CachedFile(
+            llvm::vfs::Status::copyWithNewName(contents->status, path.str()),
+            contents->buffer));
+    }
+
+private:
+    std::string absolutePath(const llvm::Twine& path) const {
+        llvm::SmallString<256> absolute;
+        path.toVector(absolute);
+        makeAbsolute(absolute);
+        return cacheKey(absolute);
+    }
+
+    SharedFileCache& m_cache;
+};
+
+SharedFileCache& SharedFileCache::instance() {
+    static SharedFileCache cache;
+    return cache;
+}
+
+llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> SharedFileCache::createFileSystem() {
+    return llvm::makeIntrusiveRefCnt<CachingFileSystem>(llvm::vfs::createPhysicalFileSystem(), *this);
+}
+
+bool SharedFileCache::findStatus(const std::string& path, llvm::ErrorOr<llvm::vfs::Status>& status) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_statuses.find(path);
+    if (it == m_statuses.end()) {
+        ++m_statMisses;
+        return false;
+    }
+    ++m_statHits;
+    status = it->second;
+    return true;
+}
+
+void SharedFileCache::storeStatus(const std::string& path, const llvm::ErrorOr<llvm::vfs::Status>& status) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_statuses.size() >= MaxStatuses) {
+        // Cheap to rebuild; not worth ordering for eviction.
+        m_statuses.clear();
+    }
+    m_statuses.emplace(path, status);
+}
+
+std::shared_ptr<const SharedFileCache::Contents> SharedFileCache::findContents(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_contents.find(path);
+    if (it == m_contents.end()) {
+        ++m_readMisses;
+        return nullptr;
+    }
+    ++m_readHits;
+    return it->second;
+}
+
+std::shared_ptr<const SharedFileCache::Contents> SharedFileCache::storeContents(
+    const std::string& path,
+    const llvm::vfs::Status& status,
+    std::unique_ptr<llvm::MemoryBuffer> buffer)
+{
+    auto contents = std::make_shared<Contents>();
+    contents->status = status;
+    contents->buffer = std::move(buffer);
+
+    // Two threads may read the same header concurrently; the first one to
+    // finish wins so every TU sees the same buffer.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto inserted = m_contents.emplace(path, contents);
+    m_statuses.emplace(path, status);
+    auto result = inserted.first->second;
+    if (inserted.second) {
+        m_contentOrder.push_back(path);
+        m_contentBytes += contents->buffer->getBufferSize();
+        evictContents();
+    }
+    return result;
+}
+
+void SharedFileCache::evictContents() {
+    // Invalidated and re-read paths leave stale keys behind; drop them (and
+    // all but the newest copy of a key) once they outnumber live entries.
+    if (m_contentOrder.size() > 2 * m_contents.size() + 64) {
+        std::deque<std::string> live;
+        std::unordered_set<std::string> seen;
+        for (auto it = m_contentOrder.rbegin(); it != m_contentOrder.rend(); ++it) {
+            if (m_contents.count(*it) && seen.insert(*it).second) {
+                live.push_front(std::move(*it));
+            }
+        }
+        m_contentOrder.swap(live);
+    }
+
+    uint64_t maxBytes = m_maxBytes.load();
+    while (m_contentBytes > maxBytes && !m_contentOrder.empty()) {
+        auto it = m_contents.find(m_contentOrder.front());
+        m_contentOrder.pop_front();
+        if (it == m_contents.end()) continue;
+        // Buffers still held by a SourceManager stay alive until released.
+        m_contentBytes -= it->second->buffer->getBufferSize();
+        m_contents.erase(it);
+        ++m_evictions;
+    }
+}
+
+void SharedFileCache::setMaxBytes(uint64_t maxBytes) {
+    m_maxBytes = maxBytes;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    evictContents();
+}
+
+std::shared_ptr<const llvm::MemoryBuffer> SharedFileCache::cachedBuffer(const std::string& path) const {
+    llvm::SmallString<256> absolute(path);
+    llvm::sys::fs::make_absolute(absolute);
+    std::string key = cacheKey(absolute);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_contents.find(key);
+    return it != m_contents.end() ? it->second->buffer : nullptr;
+}
+
+void SharedFileCache::invalidate(const std::string& path) {
+    llvm::SmallString<256> absolute(path);
+    llvm::sys::fs::make_absolute(absolute);
+    std::string key = cacheKey(absolute);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statuses.erase(key);
+    auto it = m_contents.find(key);
+    if (it != m_contents.end()) {
+        m_contentBytes -= it->second->buffer->getBufferSize();
+        m_contents.erase(it);
+    }
+}
+
+void SharedFileCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_statuses.clear();
+    m_contents.clear();
+    m_contentOrder.clear();
+    m_contentBytes = 0;
+}
+
+SharedFileCache::Stats SharedFileCache::stats() const {
+    Stats stats;
+    stats.statHits = m_statHits.load();
+    stats.statMisses = m_statMisses.load();
+    stats.readHits = m_readHits.load();
+    stats.readMisses = m_readMisses.load();
+    stats.evictions = m_evictions.load();
+    return stats;
+}
+
+} // namespace CFGAnalyzer
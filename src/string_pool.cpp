@@ -0,0 +1,48 @@
+#include "string_pool.h"
+#include <QByteArray>
+#include <cstring>
+
+namespace GraphGenerator {
+
+StringPool::Ref StringPool::intern(llvm::StringRef text) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // StringMap entries never move once inserted, so the pointer is stable.
+    return Ref(&*m_strings.insert(text).first);
+}
+
+StringPool::Ref StringPool::intern(const QString& text) {
+    QByteArray utf8 = text.toUtf8();
+    return intern(llvm::StringRef(utf8.constData(), utf8.size()));
+}
+
+const SourceFile* StringPool::addSource(const std::string& path, llvm::StringRef text,
+                                        std::shared_ptr<const void> owner) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const SourceFile*& latest = m_latestSource[path];
+    if (latest && latest->text() == text) {
+        return latest;
+    }
+
+    if (owner) {
+        m_borrowedBytes += text.size();
+    } else {
+        char* copy = m_strings.getAllocator().Allocate<char>(text.size());
+        std::memcpy(copy, text.data(), text.size());
+        text = llvm::StringRef(copy, text.size());
+    }
+    m_sources.push_back(std::make_unique<SourceFile>(path, text, std::move(owner)));
+    latest = m_sources.back().get();
+    return latest;
+}
+
+size_t StringPool::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_strings.size();
+}
+
+size_t StringPool::bytesAllocated() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_strings.getAllocator().getTotalMemory() + m_borrowedBytes;
+}
+
+} // namespace GraphGenerator
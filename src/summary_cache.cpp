@@ -0,0 +1,348 @@
+#include "summary_cache.h"
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <unordered_map>
+#include <QDebug>
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace CFGAnalyzer {
+
+namespace {
+
+// Bump when the stored summary layout changes.
+constexpr const char* CacheFormatVersion = "cfg-summary-v7";
+
+int64_t modificationTime(const llvm::sys::fs::file_status& status) {
+    return status.getLastModificationTime().time_since_epoch().count();
+}
+
+json encodeResult(const AnalysisResult& result) {
+    json encoded;
+    // SymbolIds do not survive the process; symbols are stored by USR and
+    // call edges by index into that list.
+    SymbolNames names(result.functionDependencies);
+    const SymbolTable& table = SymbolTable::instance();
+    std::unordered_map<SymbolId, size_t> indexes;
+    json symbols = json::array();
+    for (SymbolId id : names.symbols()) {
+        const Symbol& symbol = table.symbol(id);
+        indexes.emplace(id, indexes.size());
+        symbols.push_back({symbol.usr, symbol.name, symbol.parameters});
+    }
+    encoded["symbols"] = symbols;
+
+    json dependencies = json::array();
+    for (const auto* entry : names.sortedCallers()) {
+        json callees = json::array();
+        for (SymbolId callee : names.sorted(entry->second)) {
+            callees.push_back(indexes.at(callee));
+        }
+        dependencies.push_back({indexes.at(entry->first), callees});
+    }
+    encoded["functionDependencies"] = dependencies;
+
+    json functions = json::array();
+    for (const auto& [name, info] : result.functions) {
+        functions.push_back({
+            {"key", name},
+            {"name", info.name},
+            {"filename", info.filename},
+            {"line", info.line},
+            {"column", info.column},
+            {"endLine", info.endLine},
+            {"isMethod", info.isMethod},
+            {"isConstructor", info.isConstructor},
+            {"isDestructor", info.isDestructor}
+        });
+    }
+    encoded["functions"] = functions;
+
+    // Rows refer to their symbol by index. Fan-in and fan-out depend on the
+    // rest of the project and are left to linkCalls() after the merge.
+    json metrics = json::array();
+    for (uint32_t row = 0; row < result.metrics.size(); ++row) {
+        json values = json::array();
+        for (size_t m = 0; m < MetricCount; ++m) {
+            values.push_back(result.metrics.value(row, static_cast<Metric>(m)));
+        }
+        metrics.push_back({indexes.at(result.metrics.symbol(row)), values});
+    }
+    encoded["metrics"] = metrics;
+
+    // Per-function DOTs are only present when the run emitted them; a hit
+    // must hand them back so writeFunctionDots() produces the same files.
+    json dots = json::array();
+    for (const auto& [name, dot] : result.functionDots) {
+        dots.push_back({name, dot});
+    }
+    encoded["functionDots"] = dots;
+    return encoded;
+}
+
+void decodeResult(const json& encoded, AnalysisResult& result) {
+    std::vector<SymbolId> symbols;
+    for (const auto& symbol : encoded.at("symbols")) {
+        symbols.push_back(SymbolTable::instance().intern(symbol.at(0).get<std::string>(),
+                                                         symbol.at(1).get<std::string>(),
+                                                         symbol.at(2).get<std::string>()));
+    }
+    for (const auto& dependency : encoded.at("functionDependencies")) {
+        auto& callees = result.functionDependencies[symbols.at(dependency.at(0).get<size_t>())];
+        for (const auto& callee : dependency.at(1)) {
+            callees.push_back(symbols.at(callee.get<size_t>()));
+        }
+    }
+    normalizeCallGraph(result.functionDependencies);
+    for (const auto& function : encoded.at("functions")) {
+        FunctionInfo info;
+        info.name = function.at("name").get<std::string>();
+        info.filename = function.at("filename").get<std::string>();
+        info.line = function.at("line").get<unsigned>();
+        info.column = function.at("column").get<unsigned>();
+        info.endLine = function.at("endLine").get<unsigned>();
+        info.isMethod = function.at("isMethod").get<bool>();
+        info.isConstructor = function.at("isConstructor").get<bool>();
+        info.isDestructor = function.at("isDestructor").get<bool>();
+        result.functions[function.at("key").get<std::string>()] = info;
+    }
+    for (const auto& row : encoded.at("metrics")) {
+        FunctionMetrics metrics;
+        const json& values = row.at(1);
+        for (size_t m = 0; m < MetricCount && m < values.size(); ++m) {
+            metrics.values[m] = values.at(m).get<uint32_t>();
+        }
+        result.metrics.set(symbols.at(row.at(0).get<size_t>()), metrics);
+    }
+    for (const auto& dot : encoded.at("functionDots")) {
+        result.functionDots[dot.at(0).get<std::string>()] = dot.at(1).get<std::string>();
+    }
+}
+
+} // namespace
+
+SummaryCache::SummaryCache(const std::string& directory, uint64_t maxBytes)
+    : m_directory(directory), m_maxBytes(maxBytes)
+{
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if (ec) {
+        qWarning() << "Failed to create cache directory:" << m_directory.c_str()
+                   << ec.message().c_str();
+    }
+    loadIndex();
+}
+
+std::string SummaryCache::hashString(const std::string& data) {
+    llvm::MD5 hasher;
+    hasher.update(data);
+    llvm::MD5::MD5Result digest;
+    hasher.final(digest);
+    return std::string(digest.digest().str());
+}
+
+bool SummaryCache::hashFile(const std::string& path, std::string& hash) {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer) {
+        return false;
+    }
+    llvm::MD5 hasher;
+    hasher.update((*buffer)->getBuffer());
+    llvm::MD5::MD5Result digest;
+    hasher.final(digest);
+    hash = std::string(digest.digest().str());
+    return true;
+}
+
+std::string SummaryCache::manifestKey(const std::string& mainFile, const std::string& flags) const {
+    std::string mainHash;
+    if (!hashFile(mainFile, mainHash)) {
+        return std::string();
+    }
+    std::string keyData = CacheFormatVersion;
+    keyData += '\0';
+    keyData += flags;
+    keyData += '\0';
+    keyData += mainFile;
+    keyData += '\0';
+    keyData += mainHash;
+    return hashString(keyData);
+}
+
+fs::path SummaryCache::entryPath(const std::string& key) const {
+    return fs::path(m_directory) / (key + ".json");
+}
+
+void SummaryCache::loadIndex() {
+    std::lock_guard<std::mutex> lock(m_indexMutex);
+    std::error_code ec;
+    for (const auto& item : fs::directory_iterator(m_directory, ec)) {
+        if (!item.is_regular_file() || item.path().extension() != ".json") {
+            continue;
+        }
+        IndexEntry entry;
+        entry.size = item.file_size();
+        entry.lastUse = item.last_write_time();
+        m_index[item.path().stem().string()] = entry;
+        m_totalBytes += entry.size;
+    }
+}
+
+bool SummaryCache::lookup(const std::string& mainFile, const std::string& flags,
+                          AnalysisResult& result)
+{
+    std::string key = manifestKey(mainFile, flags);
+    if (key.empty()) {
+        ++m_misses;
+        return false;
+    }
+
+    fs::path path = entryPath(key);
+    std::ifstream in(path);
+    if (!in) {
+        ++m_misses;
+        return false;
+    }
+
+    try {
+        json entry = json::parse(in);
+        for (const auto& dependency : entry.at("dependencies")) {
+            std::string depPath = dependency.at("path").get<std::string>();
+            llvm::sys::fs::file_status status;
+            if (llvm::sys::fs::status(depPath, status)) {
+                ++m_misses;
+                return false;
+            }
+            if (status.getSize() == dependency.at("size").get<uint64_t>() &&
+                modificationTime(status) == dependency.at("mtime").get<int64_t>()) {
+                continue;
+            }
+            std::string hash;
+            if (!hashFile(depPath, hash) || hash != dependency.at("hash").get<std::string>()) {
+                ++m_misses;
+                return false;
+            }
+        }
+        decodeResult(entry.at("result"), result);
+    } catch (const std::exception& e) {
+        qWarning() << "Discarding corrupt cache entry" << path.string().c_str() << e.what();
+        // Nothing a partial decode left behind may reach the fresh analysis.
+        result = AnalysisResult();
+        ++m_misses;
+        return false;
+    }
+
+    touch(path);
+    ++m_hits;
+    return true;
+}
+
+void SummaryCache::store(const std::string& mainFile, const std::string& flags,
+                         const std::vector<std::string>& dependencies,
+                         const AnalysisResult& result)
+{
+    std::string key = manifestKey(mainFile, flags);
+    if (key.empty()) {
+        return;
+    }
+
+    json entry;
+    entry["mainFile"] = mainFile;
+    json deps = json::array();
+    for (const auto& dependency : dependencies) {
+        llvm::sys::fs::file_status status;
+        std::string hash;
+        if (llvm::sys::fs::status(dependency, status) || !hashFile(dependency, hash)) {
+            // A dependency we cannot fingerprint would make the entry unsound.
+            return;
+        }
+        deps.push_back({
+            {"path", dependency},
+            {"size", status.getSize()},
+            {"mtime", modificationTime(status)},
+            {"hash", hash}
+        });
+    }
+    entry["dependencies"] = deps;
+    entry["result"] = encodeResult(result);
+
+    // Other processes may share the cache directory, so the temporary name
+    // has to be unique on disk, not just within this process.
+    fs::path path = entryPath(key);
+    int fd = -1;
+    llvm::SmallString<256> tempName;
+    if (llvm::sys::fs::createUniqueFile(path.string() + ".tmp-%%%%%%%%", fd, tempName)) {
+        qWarning() << "Failed to create cache entry for" << path.string().c_str();
+        return;
+    }
+    fs::path tempPath(tempName.str().str());
+    std::error_code ec;
+    {
+        llvm::raw_fd_ostream out(fd, /*shouldClose=*/true);
+        out << entry.dump();
+        out.close();
+        if (out.has_error()) {
+            out.clear_error();
+            qWarning() << "Failed to write cache entry:" << tempPath.string().c_str();
+            fs::remove(tempPath, ec);
+            return;
+        }
+    }
+
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        fs::remove(tempPath, ec);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_indexMutex);
+    auto& indexEntry = m_index[key];
+    m_totalBytes -= indexEntry.size;
+    indexEntry.size = fs::file_size(path, ec);
+    indexEntry.lastUse = fs::file_time_type::clock::now();
+    m_totalBytes += indexEntry.size;
+    evictIfNeeded();
+}
+
+void SummaryCache::touch(const fs::path& path) {
+    std::error_code ec;
+    auto now = fs::file_time_type::clock::now();
+    fs::last_write_time(path, now, ec);
+
+    std::lock_guard<std::mutex> lock(m_indexMutex);
+    auto it = m_index.find(path.stem().string());
+    if (it != m_index.end()) {
+        it->second.lastUse = now;
+    }
+}
+
+void SummaryCache::evictIfNeeded() {
+    while (m_totalBytes > m_maxBytes && !m_index.empty()) {
+        auto oldest = m_index.begin();
+        for (auto it = m_index.begin(); it != m_index.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) {
+                oldest = it;
+            }
+        }
+        std::error_code ec;
+        fs::remove(entryPath(oldest->first), ec);
+        m_totalBytes -= oldest->second.size;
+        m_index.erase(oldest);
+        ++m_evictions;
+    }
+}
+
+SummaryCache::Stats SummaryCache::stats() const {
+    Stats stats;
+    stats.hits = m_hits.load();
+    stats.misses = m_misses.load();
+    stats.evictions = m_evictions.load();
+    return stats;
+}
+
+} // namespace CFGAnalyzer
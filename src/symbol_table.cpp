@@ -0,0 +1,139 @@
+#include "symbol_table.h"
+#include <clang/AST/Decl.h>
+#include <clang/Index/USRGeneration.h>
+#include <llvm/ADT/SmallString.h>
+#include <algorithm>
+
+namespace CFGAnalyzer {
+
+SymbolTable& SymbolTable::instance() {
+    static SymbolTable table;
+    return table;
+}
+
+SymbolId SymbolTable::intern(const std::string& usr, const std::string& name,
+                             const std::string& parameters) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto [it, inserted] = m_ids.try_emplace(usr, static_cast<SymbolId>(m_symbols.size()));
+    if (inserted) {
+        m_symbols.push_back(Symbol{usr, name, parameters});
+    }
+    return it->second;
+}
+
+SymbolId SymbolTable::intern(const clang::FunctionDecl* function) {
+    function = function->getCanonicalDecl();
+
+    std::string parameters = "(";
+    for (const auto* param : function->parameters()) {
+        if (parameters.size() > 1) {
+            parameters += ", ";
+        }
+        parameters += param->getType().getAsString();
+    }
+    if (function->isVariadic()) {
+        parameters += function->param_empty() ? "..." : ", ...";
+    }
+    parameters += ")";
+
+    std::string name = function->getQualifiedNameAsString();
+    llvm::SmallString<128> usr;
+    if (clang::index::generateUSRForDecl(function, usr)) {
+        // No USR (some implicit declarations); name and signature still
+        // separate overloads.
+        return intern(name + parameters, name, parameters);
+    }
+    return intern(std::string(usr.str()), name, parameters);
+}
+
+const Symbol& SymbolTable::symbol(SymbolId id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_symbols[id];
+}
+
+size_t SymbolTable::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_symbols.size();
+}
+
+void normalizeCallGraph(CallGraph& calls) {
+    for (auto& [caller, callees] : calls) {
+        std::sort(callees.begin(), callees.end());
+        callees.erase(std::unique(callees.begin(), callees.end()), callees.end());
+    }
+}
+
+void mergeCallGraph(CallGraph& target, CallGraph&& source) {
+    for (auto& [caller, callees] : source) {
+        auto& merged = target[caller];
+        if (merged.empty()) {
+            merged = std::move(callees);
+            continue;
+        }
+        // Both lists are sorted; merge and drop the callees they share.
+        size_t middle = merged.size();
+        merged.insert(merged.end(), callees.begin(), callees.end());
+        std::inplace_merge(merged.begin(), merged.begin() + middle, merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+    }
+}
+
+SymbolNames::SymbolNames(const CallGraph& calls) : m_calls(calls) {
+    const SymbolTable& table = SymbolTable::instance();
+    auto add = [&](SymbolId id) {
+        if (m_names.emplace(id, table.symbol(id).name).second) {
+            m_sorted.push_back(id);
+        }
+    };
+    for (const auto& [caller, callees] : calls) {
+        add(caller);
+        for (SymbolId callee : callees) {
+            add(callee);
+        }
+    }
+
+    std::unordered_map<std::string, unsigned> uses;
+    for (const auto& [id, name] : m_names) {
+        ++uses[name];
+    }
+    for (auto& [id, name] : m_names) {
+        if (uses[name] > 1) {
+            name += table.symbol(id).parameters;
+        }
+    }
+    std::sort(m_sorted.begin(), m_sorted.end(),
+              [this](SymbolId a, SymbolId b) { return less(a, b); });
+}
+
+const std::string& SymbolNames::operator[](SymbolId id) const {
+    return m_names.at(id);
+}
+
+bool SymbolNames::less(SymbolId a, SymbolId b) const {
+    int order = m_names.at(a).compare(m_names.at(b));
+    if (order != 0) {
+        return order < 0;
+    }
+    const SymbolTable& table = SymbolTable::instance();
+    return table.symbol(a).usr < table.symbol(b).usr;
+}
+
+std::vector<const CallGraph::value_type*> SymbolNames::sortedCallers() const {
+    std::vector<const CallGraph::value_type*> entries;
+    entries.reserve(m_calls.size());
+    for (const auto& entry : m_calls) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [this](const auto* a, const auto* b) { return less(a->first, b->first); });
+    return entries;
+}
+
+std::vector<SymbolId> SymbolNames::sorted(const std::vector<SymbolId>& ids) const {
+    std::vector<SymbolId> result = ids;
+    std::sort(result.begin(), result.end(),
+              [this](SymbolId a, SymbolId b) { return less(a, b); });
+    return result;
+}
+
+} // namespace CFGAnalyzer
@@ -2,7 +2,9 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <set>
 #include <stdexcept>
+#include <unordered_set>
 #include <QDebug>
 #include <QGraphicsSvgItem>
 #include <QSvgRenderer>
@@ -16,8 +18,46 @@
 
 namespace Visualizer {
 
+namespace {
+
+// Nodes and edges on any of the highlighted paths.
+struct PathHighlight {
+    std::unordered_set<int> nodes;
+    std::set<std::pair<int, int>> edges;
+
+    explicit PathHighlight(const std::vector<int>& highlightPaths) {
+        int previous = PathSeparator;
+        for (int id : highlightPaths) {
+            if (id != PathSeparator) {
+                nodes.insert(id);
+                if (previous != PathSeparator) {
+                    edges.emplace(previous, id);
+                }
+            }
+            previous = id;
+        }
+    }
+
+    bool hasNode(int id) const { return nodes.count(id) != 0; }
+    bool hasEdge(int from, int to) const { return edges.count({from, to}) != 0; }
+};
+
+} // namespace
+
+void appendPath(std::vector<int>& highlightPaths,
+                const GraphGenerator::FrozenGraph& graph,
+                const GraphGenerator::PathEnumerator::Path& path)
+{
+    if (!highlightPaths.empty()) {
+        highlightPaths.push_back(PathSeparator);
+    }
+    for (uint32_t node : path.nodes) {
+        highlightPaths.push_back(graph.id(node));
+    }
+}
+
 std::string generateDotRepresentation(
-    const GraphGenerator::CFGGraph* graph,
+    const GraphGenerator::FrozenGraph* graph,
     bool showLineNumbers,
     bool simplifyGraph,
     const std::vector<int>& highlightPaths)
@@ -30,26 +70,30 @@ std::string generateDotRepresentation(
     dot << "digraph CFG {\n";
     dot << "  node [shape=box, fontname=\"Courier\", fontsize=10];\n";
     dot << "  edge [fontsize=8];\n";
+    PathHighlight highlight(highlightPaths);
     
     // Add nodes
-    for (const auto& [id, node] : graph->getNodes()) {
-        dot << "  " << id << " [label=\"";
+    for (uint32_t i = 0; i < graph->nodeCount(); ++i) {
+        int id = graph->id(i);
+        GraphGenerator::NodeFlags flags = graph->nodeFlags(i);
+        size_t successorCount = graph->successors(i).size();
+        dot << "  " << id << " [id=\"node" << id << "\", label=\"";
                  
-        dot << graph->getNodeLabel(id).toStdString() << "\"";
+        dot << graph->label(i).toStdString() << "\"";
         
-        if (graph->isNodeTryBlock(id)) {
+        if (flags & GraphGenerator::TryBlock) {
             dot << ", style=filled, fillcolor=lightblue";
         }
-        if (graph->isNodeThrowingException(id)) {
+        if (flags & GraphGenerator::ThrowsException) {
             dot << ", style=filled, fillcolor=lightcoral";
         }
-        if (std::find(highlightPaths.begin(), highlightPaths.end(), id) != highlightPaths.end()) {
+        if (highlight.hasNode(id)) {
             dot << ", style=filled, fillcolor=yellow, penwidth=2";
         }
-        if (simplifyGraph && node.successors.size() == 1) {
+        if (simplifyGraph && successorCount == 1) {
             dot << ", shape=ellipse";
         }
-        if (node.successors.size() > 1) {
+        if (successorCount > 1) {
             dot << ", style=dashed, color=gray";
         }
         
@@ -57,18 +101,27 @@ std::string generateDotRepresentation(
     }
     
     // Add edges
-    for (const auto& [id, node] : graph->getNodes()) {
-        for (int succ : node.successors) {
-            dot << "  " << id << " -> " << succ;
+    for (uint32_t i = 0; i < graph->nodeCount(); ++i) {
+        int id = graph->id(i);
+        uint32_t edge = graph->firstEdge(i);
+        for (uint32_t target : graph->successors(i)) {
+            int succ = graph->id(target);
+            // Ids match the elements the page's highlightPaths() looks up.
+            dot << "  " << id << " -> " << succ << " [id=\"edge" << id << "_" << succ << "\"";
             
-            if (graph->isExceptionEdge(id, succ)) {
-                dot << " [color=red, style=dashed, label=\"exception\"]";
+            bool onPath = highlight.hasEdge(id, succ);
+            if (graph->edgeFlags(edge++) & GraphGenerator::ExceptionEdge) {
+                dot << ", color=red, style=dashed, label=\"exception\""
+                    << (onPath ? ", penwidth=3" : "");
             } 
+            else if (onPath) {
+                dot << ", color=orange, penwidth=3";
+            }
             else if (simplifyGraph && succ <= id) {
-                dot << " [color=blue, style=bold]";
+                dot << ", color=blue, style=bold";
             }
             
-            dot << ";\n";
+            dot << "];\n";
         }
     }
     
@@ -147,7 +200,7 @@ bool analyzeAndVisualizeCppFile(const QString& cppFilePath, QGraphicsScene* scen
 }
 
 bool exportGraph(
-    const GraphGenerator::CFGGraph* graph,
+    const GraphGenerator::FrozenGraph* graph,
     const std::string& filename,
     ExportFormat format,
     bool showLineNumbers,
@@ -186,7 +239,7 @@ std::string escapeHtml(const QString& input) {
 }
 
 std::string generateInteractiveDot(
-    const GraphGenerator::CFGGraph* graph,
+    const GraphGenerator::FrozenGraph* graph,
     bool showLineNumbers,
     const std::vector<int>& highlightPaths)
 {
@@ -195,35 +248,43 @@ std::string generateInteractiveDot(
     dot << "  node [shape=box, fontname=\"Courier\", fontsize=10, "
         << "width=1.5, height=0.8, fixedsize=true];\n";
     dot << "  edge [fontsize=8];\n";
+    PathHighlight highlight(highlightPaths);
     
-    for (const auto& [id, node] : graph->getNodes()) {
+    for (uint32_t i = 0; i < graph->nodeCount(); ++i) {
+        int id = graph->id(i);
+        GraphGenerator::NodeFlags flags = graph->nodeFlags(i);
         dot << "  " << id << " ["
-            << "label=\"" << escapeHtml(graph->getNodeLabel(id)) << "\""
+            << "label=\"" << escapeHtml(graph->label(i)) << "\""
             << ", tooltip=\"Block " << id << "\\n"
-            << "Statements: " << node.statements.size() << "\""
+            << "Statements: " << graph->statements(i).size() << "\""
             << ", URL=\"javascript:void(0)\""
             << ", target=\"_blank\"";
         
-        if (graph->isNodeTryBlock(id)) {
+        if (flags & GraphGenerator::TryBlock) {
             dot << ", fillcolor=\"#a6cee3\", style=filled";
         }
-        if (graph->isNodeThrowingException(id)) {
+        if (flags & GraphGenerator::ThrowsException) {
             dot << ", fillcolor=\"#fb9a99\", style=filled";
         }
-        if (!highlightPaths.empty() && 
-            std::find(highlightPaths.begin(), highlightPaths.end(), id) != highlightPaths.end()) {
+        if (highlight.hasNode(id)) {
             dot << ", fillcolor=\"#ffff99\", penwidth=3";
         }
         dot << "];\n";
     }
     
-    for (const auto& [id, node] : graph->getNodes()) {
-        for (int succ : node.successors) {
+    for (uint32_t i = 0; i < graph->nodeCount(); ++i) {
+        int id = graph->id(i);
+        uint32_t edge = graph->firstEdge(i);
+        for (uint32_t target : graph->successors(i)) {
+            int succ = graph->id(target);
             dot << "  " << id << " -> " << succ << " ["
                 << "tooltip=\"" << id << "→" << succ << "\"";
                 
-            if (graph->isExceptionEdge(id, succ)) {
-                dot << ", color=red, style=dashed";
+            bool onPath = highlight.hasEdge(id, succ);
+            if (graph->edgeFlags(edge++) & GraphGenerator::ExceptionEdge) {
+                dot << ", color=red, style=dashed" << (onPath ? ", penwidth=3" : "");
+            } else if (onPath) {
+                dot << ", color=orange, penwidth=3";
             } else if (succ <= id) { // Back edge
                 dot << ", color=blue, style=bold";
             }
@@ -236,7 +297,7 @@ std::string generateInteractiveDot(
 }
 
 bool exportToDot(
-    const GraphGenerator::CFGGraph* graph,
+    const GraphGenerator::FrozenGraph* graph,
     const std::string& filename,
     bool showLineNumbers,
     bool simplifyGraph,
@@ -0,0 +1,74 @@
+#include "worker_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CFGAnalyzer {
+
+WorkerPool::WorkerPool(unsigned jobs)
+    : m_jobs(jobs > 0 ? jobs : defaultJobs())
+{
+}
+
+unsigned WorkerPool::defaultJobs() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+bool WorkerPool::run(size_t count, const std::function<void(size_t)>& task,
+                     const std::function<bool(size_t)>& onComplete) {
+    if (count == 0) return true;
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> canceled{false};
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+    std::mutex completionMutex;
+
+    auto worker = [&]() {
+        while (!canceled.load(std::memory_order_relaxed)) {
+            size_t i = next.fetch_add(1);
+            if (i >= count) break;
+
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+
+            if (onComplete) {
+                std::lock_guard<std::mutex> lock(completionMutex);
+                if (!canceled.load(std::memory_order_relaxed) && !onComplete(i)) {
+                    canceled.store(true, std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+    unsigned threadCount = static_cast<unsigned>(std::min<size_t>(m_jobs, count));
+    if (threadCount <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (unsigned t = 0; t < threadCount; ++t) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+    return !canceled.load();
+}
+
+} // namespace CFGAnalyzer
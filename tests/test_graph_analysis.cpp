@@ -0,0 +1,229 @@
+#include "graph_generator.h"
+#include "frozen_graph.h"
+#include "graph_analysis.h"
+#include <QtTest>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace GraphGenerator;
+
+namespace {
+
+// Nodes 1..nodeCount with the given edges; node id n sits at index n - 1.
+std::shared_ptr<const FrozenGraph> makeGraph(int nodeCount,
+                                             std::initializer_list<std::pair<int, int>> edges) {
+    CFGGraph graph;
+    for (int id = 1; id <= nodeCount; ++id) {
+        graph.addNode(id);
+    }
+    for (const auto& [from, to] : edges) {
+        graph.addEdge(from, to);
+    }
+    return graph.freeze();
+}
+
+std::vector<uint32_t> values(FrozenGraph::Range<uint32_t> range) {
+    return std::vector<uint32_t>(range.begin(), range.end());
+}
+
+using Indices = std::vector<uint32_t>;
+constexpr uint32_t npos = FrozenGraph::npos;
+
+} // namespace
+
+class GraphAnalysisTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void freezeBuildsSortedAdjacency();
+    void dominatorsOfDiamond();
+    void postDominatorsOfDiamond();
+    void controlDependenceOfDiamond();
+    void regionsNestConditionalInLoop();
+    void componentsAndCondensation();
+    void shortestPathsInWeightOrder();
+    void depthFirstPathsInSuccessorOrder();
+    void pathWeightsAndLimits();
+};
+
+void GraphAnalysisTest::freezeBuildsSortedAdjacency() {
+    CFGGraph graph;
+    graph.addNode(30);
+    graph.addNode(10);
+    graph.addNode(20);
+    graph.addEdge(10, 30);
+    graph.addEdge(10, 20);
+    graph.addExceptionEdge(20, 30);
+    auto frozen = graph.freeze();
+
+    QCOMPARE(frozen->nodeCount(), size_t(3));
+    QCOMPARE(frozen->edgeCount(), size_t(3));
+    QCOMPARE(frozen->id(0), 10);
+    QCOMPARE(frozen->id(2), 30);
+    QCOMPARE(frozen->indexOf(20), uint32_t(1));
+    QCOMPARE(frozen->indexOf(40), npos);
+
+    QCOMPARE(values(frozen->successors(0)), (Indices{1, 2}));
+    QCOMPARE(values(frozen->predecessors(2)), (Indices{0, 1}));
+    QCOMPARE(frozen->edgeIndex(0, 2), frozen->firstEdge(0) + 1);
+    QCOMPARE(frozen->edgeIndex(2, 0), npos);
+    QVERIFY(frozen->isExceptionEdge(20, 30));
+    QVERIFY(!frozen->isExceptionEdge(10, 30));
+}
+
+void GraphAnalysisTest::dominatorsOfDiamond() {
+    // 1 branches to 2 and 3, which join at 4.
+    auto graph = makeGraph(4, {{1, 2}, {1, 3}, {2, 4}, {3, 4}});
+    const DominatorTree& dominators = graph->dominators();
+
+    QCOMPARE(dominators.idom(0), npos);
+    QCOMPARE(dominators.idom(1), uint32_t(0));
+    QCOMPARE(dominators.idom(3), uint32_t(0));
+    QVERIFY(dominators.dominates(0, 3));
+    QVERIFY(dominators.dominates(3, 3));
+    QVERIFY(!dominators.dominates(1, 3));
+    QCOMPARE(values(dominators.children(0)), (Indices{1, 2, 3}));
+    QCOMPARE(values(dominators.frontier(1)), (Indices{3}));
+    // Computed once and kept with the graph.
+    QCOMPARE(&graph->dominators(), &dominators);
+}
+
+void GraphAnalysisTest::postDominatorsOfDiamond() {
+    auto graph = makeGraph(4, {{1, 2}, {1, 3}, {2, 4}, {3, 4}});
+    const DominatorTree& postDominators = graph->postDominators();
+
+    QVERIFY(postDominators.direction() == DominatorTree::Direction::Post);
+    QCOMPARE(postDominators.idom(0), uint32_t(3));
+    QCOMPARE(postDominators.idom(1), uint32_t(3));
+    QCOMPARE(postDominators.idom(3), npos);
+    QVERIFY(postDominators.dominates(3, 0));
+    QVERIFY(!postDominators.dominates(1, 0));
+}
+
+void GraphAnalysisTest::controlDependenceOfDiamond() {
+    auto graph = makeGraph(4, {{1, 2}, {1, 3}, {2, 4}, {3, 4}});
+    const ControlDependence& dependence = graph->controlDependence();
+
+    QCOMPARE(values(dependence.dependents(0)), (Indices{1, 2}));
+    QCOMPARE(values(dependence.controllers(1)), (Indices{0}));
+    QCOMPARE(values(dependence.controllers(2)), (Indices{0}));
+    QVERIFY(dependence.controllers(3).empty());
+}
+
+void GraphAnalysisTest::regionsNestConditionalInLoop() {
+    // 2 heads a loop closed by 5 -> 2; inside it 2 branches to 3 and 4,
+    // which join at 5. 5 leaves to 6.
+    auto graph = makeGraph(6, {{1, 2}, {2, 3}, {2, 4}, {3, 5}, {4, 5}, {5, 2}, {5, 6}});
+    const RegionForest& regions = graph->regions();
+
+    QCOMPARE(regions.size(), size_t(2));
+    QVERIFY(regions[0].kind == RegionForest::Kind::Loop);
+    QCOMPARE(regions[0].entry, uint32_t(1));
+    QCOMPARE(regions[0].exit, npos);
+    QCOMPARE(regions[0].parent, npos);
+    QCOMPARE(regions[0].depth, uint32_t(0));
+    QCOMPARE(values(regions.nodes(0)), (Indices{1, 2, 3, 4}));
+
+    // The branch at 5 reaches back into the loop, so it is not a region.
+    QVERIFY(regions[1].kind == RegionForest::Kind::Conditional);
+    QCOMPARE(regions[1].entry, uint32_t(1));
+    QCOMPARE(regions[1].exit, uint32_t(4));
+    QCOMPARE(regions[1].parent, uint32_t(0));
+    QCOMPARE(regions[1].depth, uint32_t(1));
+    QCOMPARE(values(regions.nodes(1)), (Indices{1, 2, 3}));
+
+    QCOMPARE(regions.innermost(0), npos);
+    QCOMPARE(regions.innermost(2), uint32_t(1));
+    QCOMPARE(regions.innermost(4), uint32_t(0));
+    QCOMPARE(regions.headedBy(1), uint32_t(0));
+    QCOMPARE(regions.headedBy(2), npos);
+}
+
+void GraphAnalysisTest::componentsAndCondensation() {
+    // 1 and 2 call each other and 2 calls 3, which recurses; 4 is alone.
+    auto graph = makeGraph(4, {{1, 2}, {2, 1}, {2, 3}, {3, 3}});
+    const StronglyConnectedComponents& components = graph->components();
+
+    QCOMPARE(components.size(), size_t(3));
+    QCOMPARE(components.cyclicCount(), size_t(2));
+    QCOMPARE(components.componentOf(0), uint32_t(0));
+    QCOMPARE(components.componentOf(1), uint32_t(0));
+    QCOMPARE(components.componentOf(2), uint32_t(1));
+    QCOMPARE(components.componentOf(3), uint32_t(2));
+    QCOMPARE(values(components.members(0)), (Indices{0, 1}));
+    QVERIFY(components.isCyclic(0));
+    QVERIFY(components.isCyclic(1));
+    QVERIFY(!components.isCyclic(2));
+    QCOMPARE(values(components.successors(0)), (Indices{1}));
+    QVERIFY(components.successors(1).empty());
+}
+
+void GraphAnalysisTest::shortestPathsInWeightOrder() {
+    auto graph = makeGraph(4, {{1, 2}, {1, 3}, {1, 4}, {2, 4}, {3, 4}});
+    PathEnumerator paths(*graph, 0, 3);
+    PathEnumerator::Path path;
+
+    QVERIFY(paths.next(path));
+    QCOMPARE(path.nodes, (Indices{0, 3}));
+    QCOMPARE(path.weight, 1.0);
+    QVERIFY(paths.next(path));
+    QCOMPARE(path.nodes, (Indices{0, 1, 3}));
+    QCOMPARE(path.weight, 2.0);
+    QVERIFY(paths.next(path));
+    QCOMPARE(path.nodes, (Indices{0, 2, 3}));
+    QVERIFY(!paths.next(path));
+    QCOMPARE(paths.count(), size_t(3));
+    QVERIFY(!paths.truncated());
+}
+
+void GraphAnalysisTest::depthFirstPathsInSuccessorOrder() {
+    auto graph = makeGraph(4, {{1, 2}, {1, 3}, {1, 4}, {2, 4}, {3, 4}});
+    PathEnumerator::Options options;
+    options.order = PathEnumerator::Order::DepthFirst;
+    PathEnumerator paths(*graph, 0, 3, options);
+    PathEnumerator::Path path;
+
+    QVERIFY(paths.next(path));
+    QCOMPARE(path.nodes, (Indices{0, 1, 3}));
+    QVERIFY(paths.next(path));
+    QCOMPARE(path.nodes, (Indices{0, 2, 3}));
+    QVERIFY(paths.next(path));
+    QCOMPARE(path.nodes, (Indices{0, 3}));
+    QVERIFY(!paths.next(path));
+    QVERIFY(!paths.truncated());
+}
+
+void GraphAnalysisTest::pathWeightsAndLimits() {
+    auto graph = makeGraph(4, {{1, 2}, {1, 3}, {1, 4}, {2, 4}, {3, 4}});
+    PathEnumerator::Path path;
+
+    PathEnumerator::Options weighted;
+    uint32_t direct = graph->edgeIndex(0, 3);
+    weighted.weight = [direct](uint32_t edge) { return edge == direct ? 5.0 : 1.0; };
+    PathEnumerator cheapest(*graph, 0, 3, weighted);
+    QVERIFY(cheapest.next(path));
+    QCOMPARE(path.nodes, (Indices{0, 1, 3}));
+    QCOMPARE(path.weight, 2.0);
+
+    PathEnumerator::Options onePath;
+    onePath.maxPaths = 1;
+    PathEnumerator limited(*graph, 0, 3, onePath);
+    while (limited.next(path)) {}
+    QCOMPARE(limited.count(), size_t(1));
+    QVERIFY(limited.truncated());
+
+    PathEnumerator::Options fewSteps;
+    fewSteps.maxSteps = 3;
+    PathEnumerator stopped(*graph, 0, 3, fewSteps);
+    while (stopped.next(path)) {}
+    QVERIFY(stopped.truncated());
+
+    PathEnumerator unreachable(*graph, 3, 0);
+    QVERIFY(!unreachable.next(path));
+    QVERIFY(!unreachable.truncated());
+}
+
+QTEST_GUILESS_MAIN(GraphAnalysisTest)
+#include "test_graph_analysis.moc"
@@ -0,0 +1,165 @@
+#include "summary_cache.h"
+#include "symbol_table.h"
+#include <QtTest>
+#include <QTemporaryDir>
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace CFGAnalyzer;
+namespace fs = std::filesystem;
+
+namespace {
+
+void writeText(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+}
+
+// Entry files in a cache directory.
+std::vector<fs::path> entries(const std::string& directory) {
+    std::vector<fs::path> paths;
+    for (const auto& item : fs::directory_iterator(directory)) {
+        if (item.path().extension() == ".json") {
+            paths.push_back(item.path());
+        }
+    }
+    return paths;
+}
+
+} // namespace
+
+class SummaryCacheTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void roundTrip();
+    void missOnChangedFlagsOrDependency();
+    void unreadableEntryIsAMiss();
+    void partiallyDecodedEntryLeavesNothingBehind();
+
+private:
+    // Stores a small summary of m_mainFile, which includes m_header.
+    void storeSample(SummaryCache& cache, const std::string& flags = "-std=c++17");
+
+    std::unique_ptr<QTemporaryDir> m_dir;
+    std::string m_cacheDir;
+    std::string m_mainFile;
+    std::string m_header;
+    SymbolId m_caller = 0;
+    SymbolId m_callee = 0;
+};
+
+void SummaryCacheTest::init() {
+    m_dir = std::make_unique<QTemporaryDir>();
+    QVERIFY(m_dir->isValid());
+    m_cacheDir = m_dir->filePath("cache").toStdString();
+    m_mainFile = m_dir->filePath("main.cpp").toStdString();
+    m_header = m_dir->filePath("util.h").toStdString();
+    writeText(m_header, "int helper();\n");
+    writeText(m_mainFile, "#include \"util.h\"\nint main() { return helper(); }\n");
+
+    m_caller = SymbolTable::instance().intern("c:@F@main#", "main", "()");
+    m_callee = SymbolTable::instance().intern("c:@F@helper#", "helper", "()");
+}
+
+void SummaryCacheTest::storeSample(SummaryCache& cache, const std::string& flags) {
+    AnalysisResult result;
+    result.success = true;
+    result.functionDependencies[m_caller] = {m_callee};
+    FunctionInfo info;
+    info.name = "main";
+    info.filename = m_mainFile;
+    info.line = 2;
+    info.column = 1;
+    info.endLine = 2;
+    result.functions["main"] = info;
+    result.functionDots["main"] = "digraph \"main_CFG\" {\n}\n";
+    cache.store(m_mainFile, flags, {m_mainFile, m_header}, result);
+}
+
+void SummaryCacheTest::roundTrip() {
+    SummaryCache cache(m_cacheDir, 1 << 20);
+    storeSample(cache);
+    QCOMPARE(entries(m_cacheDir).size(), size_t(1));
+
+    AnalysisResult result;
+    QVERIFY(cache.lookup(m_mainFile, "-std=c++17", result));
+    QCOMPARE(result.functionDependencies.size(), size_t(1));
+    QCOMPARE(result.functionDependencies.at(m_caller), (std::vector<SymbolId>{m_callee}));
+    QCOMPARE(result.functions.size(), size_t(1));
+    const FunctionInfo& info = result.functions.at("main");
+    QCOMPARE(info.filename, m_mainFile);
+    QCOMPARE(info.line, 2u);
+    QCOMPARE(info.endLine, 2u);
+    QVERIFY(!info.isMethod);
+    QCOMPARE(result.functionDots.at("main"), std::string("digraph \"main_CFG\" {\n}\n"));
+    QCOMPARE(cache.stats().hits, uint64_t(1));
+
+    // A new instance finds the entry on disk.
+    SummaryCache reopened(m_cacheDir, 1 << 20);
+    AnalysisResult again;
+    QVERIFY(reopened.lookup(m_mainFile, "-std=c++17", again));
+    QCOMPARE(again.functions.size(), size_t(1));
+}
+
+void SummaryCacheTest::missOnChangedFlagsOrDependency() {
+    SummaryCache cache(m_cacheDir, 1 << 20);
+    storeSample(cache);
+
+    AnalysisResult otherFlags;
+    QVERIFY(!cache.lookup(m_mainFile, "-std=c++20", otherFlags));
+
+    writeText(m_header, "int helper();\nint other();\n");
+    AnalysisResult changedHeader;
+    QVERIFY(!cache.lookup(m_mainFile, "-std=c++17", changedHeader));
+    QVERIFY(changedHeader.functions.empty());
+    QCOMPARE(cache.stats().misses, uint64_t(2));
+    QCOMPARE(cache.stats().hits, uint64_t(0));
+}
+
+void SummaryCacheTest::unreadableEntryIsAMiss() {
+    SummaryCache cache(m_cacheDir, 1 << 20);
+    storeSample(cache);
+    std::vector<fs::path> stored = entries(m_cacheDir);
+    QCOMPARE(stored.size(), size_t(1));
+    writeText(stored.front().string(), "{\"dependencies\": [");
+
+    AnalysisResult result;
+    QVERIFY(!cache.lookup(m_mainFile, "-std=c++17", result));
+    QCOMPARE(cache.stats().misses, uint64_t(1));
+
+    // The next store replaces the broken entry.
+    storeSample(cache);
+    QVERIFY(cache.lookup(m_mainFile, "-std=c++17", result));
+}
+
+void SummaryCacheTest::partiallyDecodedEntryLeavesNothingBehind() {
+    SummaryCache cache(m_cacheDir, 1 << 20);
+    storeSample(cache);
+    std::vector<fs::path> stored = entries(m_cacheDir);
+    QCOMPARE(stored.size(), size_t(1));
+
+    // Symbols and call edges decode; the function list then fails.
+    nlohmann::json entry;
+    {
+        std::ifstream in(stored.front());
+        entry = nlohmann::json::parse(in);
+    }
+    entry["result"]["functions"][0].erase("name");
+    writeText(stored.front().string(), entry.dump());
+
+    AnalysisResult result;
+    QVERIFY(!cache.lookup(m_mainFile, "-std=c++17", result));
+    QVERIFY(result.functionDependencies.empty());
+    QVERIFY(result.functions.empty());
+    QVERIFY(result.functionDots.empty());
+    QCOMPARE(cache.stats().misses, uint64_t(1));
+}
+
+QTEST_GUILESS_MAIN(SummaryCacheTest)
+#include "test_summary_cache.moc"